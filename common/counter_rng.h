@@ -0,0 +1,145 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <omp.h>
+#include "static_partition.h"
+
+/*
+ * Генератор случайных чисел со счетчиком (Philox4x32-10, Salmon и др., 2011).
+ * Блок с номером counter - это 10 раундов перемешивания пары (counter, seed),
+ * поэтому i-е число потока вычисляется сразу, без генерации предыдущих.
+ * Каждый поток заполняет свой участок массива, и результат не зависит от
+ * числа потоков: элемент i всегда получает i-е число потока с данным seed.
+ */
+class CounterRng {
+public:
+    explicit CounterRng(uint64_t seed) : key0(static_cast<uint32_t>(seed)), key1(static_cast<uint32_t>(seed >> 32)) {}
+
+    // 128 случайных бит блока counter
+    std::array<uint32_t, 4> block(uint64_t counter) const {
+        uint32_t c0 = static_cast<uint32_t>(counter);
+        uint32_t c1 = static_cast<uint32_t>(counter >> 32);
+        uint32_t c2 = 0;
+        uint32_t c3 = 0;
+        uint32_t k0 = key0;
+        uint32_t k1 = key1;
+        for (int round = 0; round < 10; ++round) {
+            uint64_t product0 = static_cast<uint64_t>(PHILOX_M0) * c0;
+            uint64_t product1 = static_cast<uint64_t>(PHILOX_M1) * c2;
+            uint32_t next0 = static_cast<uint32_t>(product1 >> 32) ^ c1 ^ k0;
+            uint32_t next2 = static_cast<uint32_t>(product0 >> 32) ^ c3 ^ k1;
+            c1 = static_cast<uint32_t>(product1);
+            c3 = static_cast<uint32_t>(product0);
+            c0 = next0;
+            c2 = next2;
+            k0 += PHILOX_W0;
+            k1 += PHILOX_W1;
+        }
+        return { { c0, c1, c2, c3 } };
+    }
+
+    // i-е 32-битное число потока (4 числа на блок)
+    uint32_t bits32(uint64_t index) const {
+        return block(index / 4)[index % 4];
+    }
+
+    // i-е 64-битное число потока (2 числа на блок)
+    uint64_t bits64(uint64_t index) const {
+        std::array<uint32_t, 4> bits = block(index / 2);
+        size_t half = static_cast<size_t>(index % 2) * 2;
+        return bits[half] | static_cast<uint64_t>(bits[half + 1]) << 32;
+    }
+
+    // i-е число из [0, 1) с 53 случайными битами
+    double uniform(uint64_t index) const {
+        return to_unit(bits64(index));
+    }
+
+    // Целое из [lo, hi] по 32 битам: умножение со сдвигом вместо деления с остатком
+    static long long to_range(uint32_t bits, long long lo, long long hi) {
+        uint64_t range = static_cast<uint64_t>(hi - lo) + 1;
+        return lo + static_cast<long long>((bits * range) >> 32);
+    }
+
+    static double to_unit(uint64_t bits) {
+        return (bits >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    /*
+     * Последовательное заполнение data[0, count) элементами потока
+     * с номерами offset ... offset + count - 1: целые из [lo, hi] (диапазон до 2^32)
+     */
+    template <typename T>
+    void fill_int(T* data, size_t count, long long lo, long long hi, uint64_t offset = 0) const {
+        std::array<uint32_t, 4> bits = {};
+        for (size_t i = 0; i < count; ++i) {
+            uint64_t index = offset + i;
+            if (i == 0 || index % 4 == 0) {
+                bits = block(index / 4);
+            }
+            data[i] = static_cast<T>(to_range(bits[index % 4], lo, hi));
+        }
+    }
+
+    // То же для вещественных чисел из [lo, hi)
+    template <typename T>
+    void fill_real(T* data, size_t count, double lo, double hi, uint64_t offset = 0) const {
+        std::array<uint32_t, 4> bits = {};
+        for (size_t i = 0; i < count; ++i) {
+            uint64_t index = offset + i;
+            if (i == 0 || index % 2 == 0) {
+                bits = block(index / 2);
+            }
+            size_t half = static_cast<size_t>(index % 2) * 2;
+            uint64_t value = bits[half] | static_cast<uint64_t>(bits[half + 1]) << 32;
+            data[i] = static_cast<T>(lo + (hi - lo) * to_unit(value));
+        }
+    }
+
+private:
+    static const uint32_t PHILOX_M0 = 0xD2511F53u;
+    static const uint32_t PHILOX_M1 = 0xCD9E8D57u;
+    static const uint32_t PHILOX_W0 = 0x9E3779B9u;
+    static const uint32_t PHILOX_W1 = 0xBB67AE85u;
+
+    uint32_t key0;
+    uint32_t key1;
+};
+
+// Случайное начальное значение для запусков, которые не нужно воспроизводить
+inline uint64_t random_seed() {
+    std::random_device rd;
+    return static_cast<uint64_t>(rd()) << 32 | rd();
+}
+
+// Параллельное заполнение целыми из [lo, hi]: каждый поток заполняет свой участок
+template <typename T>
+void parallel_fill_int(T* data, size_t count, long long lo, long long hi, uint64_t seed, uint64_t offset = 0) {
+    const CounterRng rng(seed);
+#pragma omp parallel
+    {
+        size_t threads = omp_get_num_threads();
+        size_t id = omp_get_thread_num();
+        size_t begin = 0, end = 0;
+        static_range(count, threads, id, begin, end);
+        rng.fill_int(data + begin, end - begin, lo, hi, offset + begin);
+    }
+}
+
+// Параллельное заполнение вещественными числами из [lo, hi)
+template <typename T>
+void parallel_fill_real(T* data, size_t count, double lo, double hi, uint64_t seed, uint64_t offset = 0) {
+    const CounterRng rng(seed);
+#pragma omp parallel
+    {
+        size_t threads = omp_get_num_threads();
+        size_t id = omp_get_thread_num();
+        size_t begin = 0, end = 0;
+        static_range(count, threads, id, begin, end);
+        rng.fill_real(data + begin, end - begin, lo, hi, offset + begin);
+    }
+}
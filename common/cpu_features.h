@@ -0,0 +1,65 @@
+#pragma once
+
+/*
+ * Определение возможностей процессора во время выполнения.
+ * Ядра с AVX2 компилируются с атрибутом TARGET_AVX2 (на MSVC атрибут не нужен)
+ * и вызываются только если cpu_features().avx2 и cpu_features().fma истинны,
+ * поэтому программа запускается и на процессорах без AVX2.
+ */
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define CPU_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(CPU_X86) && (defined(__GNUC__) || defined(__clang__))
+#define TARGET_AVX2 __attribute__((target("avx2,fma")))
+#else
+#define TARGET_AVX2
+#endif
+
+struct CpuFeatures {
+    bool sse2 = false;
+    bool avx2 = false;
+    bool fma = false;
+    bool avx512f = false;
+};
+
+inline CpuFeatures detect_cpu_features() {
+    CpuFeatures features;
+#if defined(CPU_X86) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    const int max_leaf = info[0];
+    __cpuid(info, 1);
+    features.sse2 = (info[3] >> 26) & 1;
+    const bool osxsave = (info[2] >> 27) & 1;
+    const bool fma = (info[2] >> 12) & 1;
+    // Регистры YMM/ZMM должны сохраняться операционной системой
+    const unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+    const bool ymm_enabled = (xcr0 & 0x6) == 0x6;
+    const bool zmm_enabled = (xcr0 & 0xe6) == 0xe6;
+    if (max_leaf >= 7) {
+        __cpuidex(info, 7, 0);
+        features.avx2 = ymm_enabled && ((info[1] >> 5) & 1);
+        features.avx512f = zmm_enabled && ((info[1] >> 16) & 1);
+    }
+    features.fma = ymm_enabled && fma;
+#elif defined(CPU_X86) && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+    features.sse2 = __builtin_cpu_supports("sse2");
+    features.avx2 = __builtin_cpu_supports("avx2");
+    features.fma = __builtin_cpu_supports("fma");
+    features.avx512f = __builtin_cpu_supports("avx512f");
+#endif
+    return features;
+}
+
+// Возможности процессора (определяются один раз)
+inline const CpuFeatures& cpu_features() {
+    static const CpuFeatures features = detect_cpu_features();
+    return features;
+}
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <algorithm>
+#include <utility>
+#include <type_traits>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+// Выравнивание буфера и начала каждой строки матрицы (строка кэша)
+const size_t MATRIX_ALIGNMENT = 64;
+
+/*
+ * Невладеющее представление прямоугольного блока матрицы:
+ * элемент (i, j) лежит по адресу data + i * ld + j
+ */
+template <typename T>
+class MatrixView {
+public:
+    MatrixView() = default;
+    MatrixView(T* data, size_t rows, size_t cols, size_t ld) : ptr(data), rows_count(rows), cols_count(cols), stride(ld) {}
+
+    // Представление только для чтения из изменяемого
+    operator MatrixView<const T>() const { return MatrixView<const T>(ptr, rows_count, cols_count, stride); }
+
+    T* operator[](size_t i) const { return ptr + i * stride; }
+    T& operator()(size_t i, size_t j) const { return ptr[i * stride + j]; }
+    T* row(size_t i) const { return ptr + i * stride; }
+    T* data() const { return ptr; }
+
+    size_t rows() const { return rows_count; }
+    size_t cols() const { return cols_count; }
+    size_t ld() const { return stride; }
+
+    // Блок rows x cols с левым верхним углом (row, col)
+    MatrixView block(size_t row, size_t col, size_t rows, size_t cols) const {
+        return MatrixView(ptr + row * stride + col, rows, cols, stride);
+    }
+
+private:
+    T* ptr = nullptr;
+    size_t rows_count = 0;
+    size_t cols_count = 0;
+    size_t stride = 0;
+};
+
+// Тег конструктора Matrix без заполнения: буфер не трогается до первой записи,
+// поэтому страницы можно разместить на узлах NUMA параллельным заполнением
+struct MatrixNoInit {};
+
+/*
+ * Плотная матрица в одном буфере, выровненном по MATRIX_ALIGNMENT.
+ * Хранение по строкам с ведущей размерностью ld >= cols: ld дополняется так,
+ * чтобы каждая строка начиналась с границы строки кэша.
+ * Только перемещение: копия делается явно через clone().
+ */
+template <typename T>
+class Matrix {
+    static_assert(std::is_trivially_copyable<T>::value, "Matrix хранит только тривиально копируемые типы");
+
+public:
+    Matrix() = default;
+
+    Matrix(size_t rows, size_t cols, T value = T()) : rows_count(rows), cols_count(cols), stride(padded_ld(cols)) {
+        ptr = allocate(rows_count * stride);
+        std::fill(ptr, ptr + rows_count * stride, value);
+    }
+
+    // Матрица с неинициализированными элементами
+    Matrix(size_t rows, size_t cols, MatrixNoInit) : rows_count(rows), cols_count(cols), stride(padded_ld(cols)) {
+        ptr = allocate(rows_count * stride);
+    }
+
+    ~Matrix() { deallocate(ptr); }
+
+    Matrix(const Matrix&) = delete;
+    Matrix& operator=(const Matrix&) = delete;
+
+    Matrix(Matrix&& other) noexcept
+        : ptr(std::exchange(other.ptr, nullptr)), rows_count(std::exchange(other.rows_count, 0)),
+        cols_count(std::exchange(other.cols_count, 0)), stride(std::exchange(other.stride, 0)) {
+    }
+
+    Matrix& operator=(Matrix&& other) noexcept {
+        if (this != &other) {
+            deallocate(ptr);
+            ptr = std::exchange(other.ptr, nullptr);
+            rows_count = std::exchange(other.rows_count, 0);
+            cols_count = std::exchange(other.cols_count, 0);
+            stride = std::exchange(other.stride, 0);
+        }
+        return *this;
+    }
+
+    // Явная глубокая копия
+    Matrix clone() const {
+        Matrix copy;
+        copy.rows_count = rows_count;
+        copy.cols_count = cols_count;
+        copy.stride = stride;
+        copy.ptr = allocate(rows_count * stride);
+        std::copy(ptr, ptr + rows_count * stride, copy.ptr);
+        return copy;
+    }
+
+    // m[i] - указатель на строку i, поэтому работает привычная запись m[i][j]
+    T* operator[](size_t i) { return ptr + i * stride; }
+    const T* operator[](size_t i) const { return ptr + i * stride; }
+    T& operator()(size_t i, size_t j) { return ptr[i * stride + j]; }
+    const T& operator()(size_t i, size_t j) const { return ptr[i * stride + j]; }
+    T* row(size_t i) { return ptr + i * stride; }
+    const T* row(size_t i) const { return ptr + i * stride; }
+    T* data() { return ptr; }
+    const T* data() const { return ptr; }
+
+    size_t rows() const { return rows_count; }
+    size_t cols() const { return cols_count; }
+    size_t ld() const { return stride; }
+    bool empty() const { return rows_count == 0 || cols_count == 0; }
+
+    MatrixView<T> view() { return MatrixView<T>(ptr, rows_count, cols_count, stride); }
+    MatrixView<const T> view() const { return MatrixView<const T>(ptr, rows_count, cols_count, stride); }
+
+    MatrixView<T> block(size_t row, size_t col, size_t rows, size_t cols) {
+        return view().block(row, col, rows, cols);
+    }
+    MatrixView<const T> block(size_t row, size_t col, size_t rows, size_t cols) const {
+        return view().block(row, col, rows, cols);
+    }
+
+    void fill(T value) { std::fill(ptr, ptr + rows_count * stride, value); }
+
+private:
+    // Наименьшее ld >= cols, при котором строка занимает целое число строк кэша
+    static size_t padded_ld(size_t cols) {
+        if (MATRIX_ALIGNMENT % sizeof(T) != 0) return cols;
+        const size_t per_line = MATRIX_ALIGNMENT / sizeof(T);
+        return (cols + per_line - 1) / per_line * per_line;
+    }
+
+    static T* allocate(size_t count) {
+        if (count == 0) return nullptr;
+        size_t bytes = (count * sizeof(T) + MATRIX_ALIGNMENT - 1) / MATRIX_ALIGNMENT * MATRIX_ALIGNMENT;
+#ifdef _WIN32
+        void* memory = _aligned_malloc(bytes, MATRIX_ALIGNMENT);
+#else
+        void* memory = nullptr;
+        if (posix_memalign(&memory, MATRIX_ALIGNMENT, bytes) != 0) memory = nullptr;
+#endif
+        if (memory == nullptr) throw std::bad_alloc();
+        return static_cast<T*>(memory);
+    }
+
+    static void deallocate(T* memory) {
+#ifdef _WIN32
+        _aligned_free(memory);
+#else
+        free(memory);
+#endif
+    }
+
+    T* ptr = nullptr;
+    size_t rows_count = 0;
+    size_t cols_count = 0;
+    size_t stride = 0;
+};
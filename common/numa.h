@@ -0,0 +1,265 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <utility>
+#include <algorithm>
+#include <vector>
+#include <omp.h>
+#include "static_partition.h"
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#include <malloc.h>
+#elif defined(__linux__)
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
+/*
+ * Размещение данных на узлах NUMA по принципу первого касания: система выделяет
+ * физическую страницу на узле того потока, который первым записал в нее.
+ * Если массив обнуляет главный поток, все страницы оказываются на одном узле,
+ * и параллельный проход упирается в пропускную способность памяти одного сокета.
+ * Здесь память не инициализируется, а страницы касаются параллельно тем же
+ * статическим разбиением, каким потоки потом читают данные.
+ */
+
+// Размер страницы для первого касания и проверки размещения
+const size_t NUMA_PAGE_SIZE = 4096;
+// Число страниц участка потока, по которым проверяется их узел
+const size_t NUMA_SAMPLE_PAGES = 64;
+
+/*
+ * Параллельное первое касание страниц буфера: поток пишет по байту в каждую страницу
+ * своего участка. Участки - static_range по байтам с шагом в страницу, а не omp for:
+ * разбиение schedule(static) в OpenMP зависит от реализации
+ */
+inline void first_touch(void* data, size_t bytes) {
+    char* memory = static_cast<char*>(data);
+#pragma omp parallel
+    {
+        size_t begin = 0, end = 0;
+        static_range(bytes, omp_get_num_threads(), omp_get_thread_num(), begin, end, NUMA_PAGE_SIZE);
+        for (size_t offset = begin; offset < end; offset += NUMA_PAGE_SIZE) {
+            memory[offset] = 0;
+        }
+    }
+}
+
+/*
+ * Аллокатор для std::vector: буфер выравнивается по странице и касается
+ * параллельно в allocate(), а construct() без аргументов не обнуляет элементы,
+ * поэтому std::vector<T, FirstTouchAllocator<T>>(n) не трогает память из главного потока.
+ */
+template <typename T>
+class FirstTouchAllocator {
+public:
+    using value_type = T;
+
+    FirstTouchAllocator() = default;
+    template <typename U>
+    FirstTouchAllocator(const FirstTouchAllocator<U>&) {}
+
+    T* allocate(size_t count) {
+        if (count == 0) return nullptr;
+        size_t bytes = (count * sizeof(T) + NUMA_PAGE_SIZE - 1) / NUMA_PAGE_SIZE * NUMA_PAGE_SIZE;
+#ifdef _WIN32
+        void* memory = _aligned_malloc(bytes, NUMA_PAGE_SIZE);
+#else
+        void* memory = nullptr;
+        if (posix_memalign(&memory, NUMA_PAGE_SIZE, bytes) != 0) memory = nullptr;
+#endif
+        if (memory == nullptr) throw std::bad_alloc();
+        first_touch(memory, bytes);
+        return static_cast<T*>(memory);
+    }
+
+    void deallocate(T* memory, size_t) {
+#ifdef _WIN32
+        _aligned_free(memory);
+#else
+        free(memory);
+#endif
+    }
+
+    // Инициализация по умолчанию: для int и double значение не записывается
+    template <typename U>
+    void construct(U* p) { ::new (static_cast<void*>(p)) U; }
+
+    template <typename U, typename... Args>
+    void construct(U* p, Args&&... args) { ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...); }
+};
+
+template <typename T, typename U>
+bool operator==(const FirstTouchAllocator<T>&, const FirstTouchAllocator<U>&) { return true; }
+
+template <typename T, typename U>
+bool operator!=(const FirstTouchAllocator<T>&, const FirstTouchAllocator<U>&) { return false; }
+
+template <typename T>
+using FirstTouchVector = std::vector<T, FirstTouchAllocator<T>>;
+
+// Логические процессоры, доступные процессу
+inline std::vector<int> available_cpus() {
+    std::vector<int> cpus;
+#ifdef _WIN32
+    DWORD_PTR process_mask = 0, system_mask = 0;
+    if (GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask)) {
+        for (int cpu = 0; cpu < static_cast<int>(sizeof(DWORD_PTR) * 8); ++cpu) {
+            if ((process_mask >> cpu) & 1) cpus.push_back(cpu);
+        }
+    }
+#elif defined(__linux__)
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &allowed)) cpus.push_back(cpu);
+        }
+    }
+#endif
+    return cpus;
+}
+
+/*
+ * Привязка потоков OpenMP к процессорам: поток i закрепляется за i-м доступным
+ * логическим процессором (по кругу, если потоков больше). Пул потоков OpenMP
+ * переиспользуется между параллельными областями, поэтому привязка сохраняется,
+ * и поток, коснувшийся страниц, потом читает их с того же узла.
+ * Вызывается до выделения данных. Возвращает число привязанных потоков.
+ * На Windows учитывается только текущая группа процессоров (до 64).
+ */
+inline int pin_threads() {
+    const std::vector<int> cpus = available_cpus();
+    if (cpus.empty()) return 0;
+
+    int pinned = 0;
+#pragma omp parallel reduction(+:pinned)
+    {
+        const int cpu = cpus[omp_get_thread_num() % cpus.size()];
+#ifdef _WIN32
+        if (SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpu) != 0) pinned++;
+#elif defined(__linux__)
+        cpu_set_t mask;
+        CPU_ZERO(&mask);
+        CPU_SET(cpu, &mask);
+        if (sched_setaffinity(0, sizeof(mask), &mask) == 0) pinned++;
+#else
+        (void)cpu;
+#endif
+    }
+    return pinned;
+}
+
+// Узел NUMA процессора, на котором сейчас выполняется поток
+inline int current_numa_node() {
+#ifdef _WIN32
+    PROCESSOR_NUMBER processor;
+    GetCurrentProcessorNumberEx(&processor);
+    USHORT node = 0;
+    if (GetNumaProcessorNodeEx(&processor, &node)) return node;
+#elif defined(__linux__) && defined(SYS_getcpu)
+    unsigned int cpu = 0, node = 0;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) return static_cast<int>(node);
+#endif
+    return 0;
+}
+
+// Узел NUMA, на котором размещена страница адреса, или -1, если страница не выделена или узел неизвестен
+inline int page_numa_node(const void* address) {
+    const uintptr_t page = reinterpret_cast<uintptr_t>(address) / NUMA_PAGE_SIZE * NUMA_PAGE_SIZE;
+#ifdef _WIN32
+    PSAPI_WORKING_SET_EX_INFORMATION info;
+    info.VirtualAddress = reinterpret_cast<void*>(page);
+    if (QueryWorkingSetEx(GetCurrentProcess(), &info, sizeof(info)) && info.VirtualAttributes.Valid) {
+        return static_cast<int>(info.VirtualAttributes.Node);
+    }
+#elif defined(__linux__) && defined(SYS_move_pages)
+    // move_pages без списка узлов только сообщает, где лежит страница
+    void* pages[1] = { reinterpret_cast<void*>(page) };
+    int status[1] = { -1 };
+    if (syscall(SYS_move_pages, 0, 1UL, pages, nullptr, status, 0) == 0 && status[0] >= 0) return status[0];
+#else
+    (void)page;
+#endif
+    return -1;
+}
+
+// Пропускная способность, достигнутая потоками одного узла
+struct NodeBandwidth {
+    int node = 0;
+    int threads = 0;
+    double bytes = 0.0;
+    // Время самого медленного потока узла (лучшее из повторов)
+    double seconds = 0.0;
+    size_t local_pages = 0;
+    size_t checked_pages = 0;
+};
+
+/*
+ * Замер пропускной способности по узлам NUMA. work(begin, end) обрабатывает
+ * элементы [begin, end) участка потока, разбиение - static_range.
+ * Каждый поток замеряет свое время, узел определяется по процессору потока,
+ * у части страниц участка проверяется, лежат ли они на том же узле.
+ * data и element_bytes нужны только для проверки размещения страниц.
+ */
+template <typename Work>
+std::vector<NodeBandwidth> measure_node_bandwidth(const void* data, size_t count, size_t element_bytes, int repeats, Work work) {
+    const int threads = omp_get_max_threads();
+    std::vector<int> nodes(threads, 0);
+    std::vector<double> seconds(threads, 0.0);
+    std::vector<double> bytes(threads, 0.0);
+    std::vector<size_t> local(threads, 0), checked(threads, 0);
+    int team = threads;
+
+#pragma omp parallel num_threads(threads)
+    {
+        const size_t total = omp_get_num_threads();
+        const size_t id = omp_get_thread_num();
+#pragma omp master
+        team = static_cast<int>(total);
+        size_t begin = 0, end = 0;
+        static_range(count, total, id, begin, end);
+        bytes[id] = static_cast<double>(end - begin) * element_bytes;
+        nodes[id] = current_numa_node();
+
+        for (int repeat = 0; repeat < repeats; ++repeat) {
+#pragma omp barrier
+            double start = omp_get_wtime();
+            work(begin, end);
+            double time = omp_get_wtime() - start;
+            seconds[id] = (repeat == 0) ? time : std::min(seconds[id], time);
+        }
+
+        const char* first = static_cast<const char*>(data) + begin * element_bytes;
+        const size_t pages = ((end - begin) * element_bytes + NUMA_PAGE_SIZE - 1) / NUMA_PAGE_SIZE;
+        const size_t step = std::max<size_t>(1, pages / NUMA_SAMPLE_PAGES);
+        for (size_t page = 0; page < pages; page += step) {
+            int node = page_numa_node(first + page * NUMA_PAGE_SIZE);
+            if (node < 0) continue;
+            checked[id]++;
+            if (node == nodes[id]) local[id]++;
+        }
+    }
+
+    std::vector<NodeBandwidth> report;
+    for (int id = 0; id < team; ++id) {
+        auto it = std::find_if(report.begin(), report.end(), [&](const NodeBandwidth& r) { return r.node == nodes[id]; });
+        if (it == report.end()) {
+            report.push_back(NodeBandwidth());
+            it = report.end() - 1;
+            it->node = nodes[id];
+        }
+        it->threads++;
+        it->bytes += bytes[id];
+        it->seconds = std::max(it->seconds, seconds[id]);
+        it->local_pages += local[id];
+        it->checked_pages += checked[id];
+    }
+    std::sort(report.begin(), report.end(), [](const NodeBandwidth& a, const NodeBandwidth& b) { return a.node < b.node; });
+    return report;
+}
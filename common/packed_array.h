@@ -0,0 +1,223 @@
+#pragma once
+
+#include <cstddef>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <utility>
+#include "cpu_features.h"
+
+/*
+ * Компактное хранение целых чисел с известным диапазоном [min_value, max_value].
+ * Хранится разность value - min_value в 1 байте (диапазон до 256 значений),
+ * 2 байтах (до 65536) или 4 байтах, поэтому при редукции, ограниченной
+ * пропускной способностью памяти, читается в 2-4 раза меньше данных.
+ * Ядра суммы расширяют значения в регистрах SIMD до 64 бит и не переполняются.
+ */
+
+// Значения uint16 копятся в 32-битных полосах не дольше этого числа элементов (65536 шагов SSE2)
+const size_t PACKED_U16_BLOCK = size_t(1) << 19;
+
+// Ширина хранения в байтах для диапазона [min_value, max_value]
+inline int packed_width(int min_value, int max_value) {
+    unsigned int span = static_cast<unsigned int>(max_value) - static_cast<unsigned int>(min_value);
+    if (span <= UINT8_MAX) return 1;
+    if (span <= UINT16_MAX) return 2;
+    return 4;
+}
+
+// Упаковка count значений в out (width байт на значение, хранится value - min_value)
+inline void pack_values(const int* values, size_t count, int min_value, int width, void* out) {
+    const long long total = static_cast<long long>(count);
+#pragma omp parallel for schedule(static)
+    for (long long i = 0; i < total; ++i) {
+        uint32_t stored = static_cast<uint32_t>(values[i]) - static_cast<uint32_t>(min_value);
+        if (width == 1) {
+            static_cast<uint8_t*>(out)[i] = static_cast<uint8_t>(stored);
+        }
+        else if (width == 2) {
+            static_cast<uint16_t*>(out)[i] = static_cast<uint16_t>(stored);
+        }
+        else {
+            static_cast<uint32_t*>(out)[i] = stored;
+        }
+    }
+}
+
+template <typename T>
+unsigned long long packed_sum_scalar(const T* data, size_t count) {
+    unsigned long long acc0 = 0, acc1 = 0, acc2 = 0, acc3 = 0;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        acc0 += data[i];
+        acc1 += data[i + 1];
+        acc2 += data[i + 2];
+        acc3 += data[i + 3];
+    }
+    for (; i < count; ++i) {
+        acc0 += data[i];
+    }
+    return acc0 + acc1 + acc2 + acc3;
+}
+
+#ifdef CPU_X86
+inline unsigned long long horizontal_sum_u64(__m128i v) {
+    unsigned long long parts[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(parts), v);
+    return parts[0] + parts[1];
+}
+
+// psadbw с нулем: сумма каждых 8 байт в 64-битной полосе
+inline unsigned long long packed_sum_u8_sse2(const uint8_t* data, size_t count) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i acc0 = zero, acc1 = zero;
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        acc0 = _mm_add_epi64(acc0, _mm_sad_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)), zero));
+        acc1 = _mm_add_epi64(acc1, _mm_sad_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 16)), zero));
+    }
+    return horizontal_sum_u64(_mm_add_epi64(acc0, acc1)) + packed_sum_scalar(data + i, count - i);
+}
+
+TARGET_AVX2 inline unsigned long long packed_sum_u8_avx2(const uint8_t* data, size_t count) {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i acc0 = zero, acc1 = zero;
+    size_t i = 0;
+    for (; i + 64 <= count; i += 64) {
+        acc0 = _mm256_add_epi64(acc0, _mm256_sad_epu8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)), zero));
+        acc1 = _mm256_add_epi64(acc1, _mm256_sad_epu8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 32)), zero));
+    }
+    __m256i acc = _mm256_add_epi64(acc0, acc1);
+    __m128i half = _mm_add_epi64(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    return horizontal_sum_u64(half) + packed_sum_scalar(data + i, count - i);
+}
+
+/*
+ * uint16 расширяются до 32 бит и копятся в 32-битных полосах; каждая полоса
+ * получает не больше 65536 значений за блок, после блока полосы расширяются до 64 бит
+ */
+inline unsigned long long packed_sum_u16_sse2(const uint16_t* data, size_t count) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i total = zero;
+    size_t i = 0;
+    while (i + 8 <= count) {
+        const size_t block_end = i + std::min(PACKED_U16_BLOCK, (count - i) / 8 * 8);
+        __m128i acc0 = zero, acc1 = zero;
+        for (; i < block_end; i += 8) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            acc0 = _mm_add_epi32(acc0, _mm_unpacklo_epi16(v, zero));
+            acc1 = _mm_add_epi32(acc1, _mm_unpackhi_epi16(v, zero));
+        }
+        total = _mm_add_epi64(total, _mm_add_epi64(_mm_unpacklo_epi32(acc0, zero), _mm_unpackhi_epi32(acc0, zero)));
+        total = _mm_add_epi64(total, _mm_add_epi64(_mm_unpacklo_epi32(acc1, zero), _mm_unpackhi_epi32(acc1, zero)));
+    }
+    return horizontal_sum_u64(total) + packed_sum_scalar(data + i, count - i);
+}
+
+TARGET_AVX2 inline unsigned long long packed_sum_u16_avx2(const uint16_t* data, size_t count) {
+    __m256i total = _mm256_setzero_si256();
+    size_t i = 0;
+    while (i + 16 <= count) {
+        const size_t block_end = i + std::min(PACKED_U16_BLOCK, (count - i) / 16 * 16);
+        __m256i acc0 = _mm256_setzero_si256(), acc1 = _mm256_setzero_si256();
+        for (; i < block_end; i += 16) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            acc0 = _mm256_add_epi32(acc0, _mm256_cvtepu16_epi32(_mm256_castsi256_si128(v)));
+            acc1 = _mm256_add_epi32(acc1, _mm256_cvtepu16_epi32(_mm256_extracti128_si256(v, 1)));
+        }
+        __m256i acc = _mm256_add_epi64(_mm256_cvtepu32_epi64(_mm256_castsi256_si128(acc0)), _mm256_cvtepu32_epi64(_mm256_extracti128_si256(acc0, 1)));
+        acc = _mm256_add_epi64(acc, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(acc1)));
+        acc = _mm256_add_epi64(acc, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(acc1, 1)));
+        total = _mm256_add_epi64(total, acc);
+    }
+    __m128i half = _mm_add_epi64(_mm256_castsi256_si128(total), _mm256_extracti128_si256(total, 1));
+    return horizontal_sum_u64(half) + packed_sum_scalar(data + i, count - i);
+}
+#endif
+
+/*
+ * Сумма хранимых значений (без учета min_value) участка упакованного массива.
+ * Ядро выбирается по ширине и возможностям процессора; 4-байтовые значения
+ * суммируются переносимым циклом с четырьмя аккумуляторами.
+ */
+inline unsigned long long packed_sum(const void* data, size_t count, int width) {
+    if (width == 1) {
+        const uint8_t* values = static_cast<const uint8_t*>(data);
+#ifdef CPU_X86
+        if (cpu_features().avx2) return packed_sum_u8_avx2(values, count);
+        if (cpu_features().sse2) return packed_sum_u8_sse2(values, count);
+#endif
+        return packed_sum_scalar(values, count);
+    }
+    if (width == 2) {
+        const uint16_t* values = static_cast<const uint16_t*>(data);
+#ifdef CPU_X86
+        if (cpu_features().avx2) return packed_sum_u16_avx2(values, count);
+        if (cpu_features().sse2) return packed_sum_u16_sse2(values, count);
+#endif
+        return packed_sum_scalar(values, count);
+    }
+    return packed_sum_scalar(static_cast<const uint32_t*>(data), count);
+}
+
+// Упакованный массив: ширина хранения выбирается по объявленному диапазону значений
+class PackedArray {
+public:
+    PackedArray() = default;
+
+    PackedArray(const int* values, size_t count, int min_value, int max_value)
+        : count(count), width(packed_width(min_value, max_value)), min_value(min_value) {
+        buffer = count > 0 ? std::malloc(count * width) : nullptr;
+        if (count > 0 && buffer == nullptr) throw std::bad_alloc();
+        pack_values(values, count, min_value, width, buffer);
+    }
+
+    ~PackedArray() { std::free(buffer); }
+
+    PackedArray(const PackedArray&) = delete;
+    PackedArray& operator=(const PackedArray&) = delete;
+
+    PackedArray(PackedArray&& other) noexcept
+        : buffer(std::exchange(other.buffer, nullptr)), count(std::exchange(other.count, 0)),
+        width(other.width), min_value(other.min_value) {
+    }
+
+    PackedArray& operator=(PackedArray&& other) noexcept {
+        if (this != &other) {
+            std::free(buffer);
+            buffer = std::exchange(other.buffer, nullptr);
+            count = std::exchange(other.count, 0);
+            width = other.width;
+            min_value = other.min_value;
+        }
+        return *this;
+    }
+
+    size_t size() const { return count; }
+    // Байт на элемент: 1, 2 или 4
+    int element_width() const { return width; }
+    size_t bytes() const { return count * width; }
+    const void* data() const { return buffer; }
+
+    int operator[](size_t i) const {
+        uint32_t stored = width == 1 ? static_cast<const uint8_t*>(buffer)[i]
+            : width == 2 ? static_cast<const uint16_t*>(buffer)[i] : static_cast<const uint32_t*>(buffer)[i];
+        return static_cast<int>(stored + static_cast<uint32_t>(min_value));
+    }
+
+    // Сумма элементов [begin, end)
+    long long sum(size_t begin, size_t end) const {
+        const char* first = static_cast<const char*>(buffer) + begin * width;
+        unsigned long long stored = packed_sum(first, end - begin, width);
+        return static_cast<long long>(stored) + static_cast<long long>(min_value) * static_cast<long long>(end - begin);
+    }
+
+    long long sum() const { return sum(0, count); }
+
+private:
+    void* buffer = nullptr;
+    size_t count = 0;
+    int width = 4;
+    int min_value = 0;
+};
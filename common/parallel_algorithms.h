@@ -0,0 +1,186 @@
+#pragma once
+
+#include <cstddef>
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
+#include <omp.h>
+#include "static_partition.h"
+
+/*
+ * Параллельные редукция и префиксная сумма для OpenMP.
+ * Диапазон делится на непрерывные участки по числу потоков (как schedule(static)),
+ * каждый поток пишет частичный результат в свою строку кэша, затем частичные
+ * результаты объединяются в порядке номеров потоков. Поэтому для ассоциативной
+ * операции результат совпадает с последовательным; для операций, ассоциативных
+ * лишь приближенно (сложение double), он повторяется от запуска к запуску
+ * при том же числе потоков.
+ */
+
+// Размер строки кэша: частичные результаты соседних потоков не делят строку
+const size_t PARALLEL_CACHE_LINE = 64;
+
+// Частичный результат потока в своей строке кэша (std::vector соблюдает alignas начиная с C++17)
+template <typename T>
+struct alignas(PARALLEL_CACHE_LINE) PaddedValue {
+    T value;
+};
+
+/*
+ * Редукция по участкам: block(begin, end) возвращает результат для [begin, end)
+ * (например, ядро SIMD), результаты участков объединяются op в порядке потоков.
+ * identity - нейтральный элемент op, он же результат для пустого диапазона
+ */
+template <typename T, typename Block, typename Op>
+T parallel_reduce_blocks(size_t count, T identity, Block block, Op op, size_t grain = 1) {
+    std::vector<PaddedValue<T>> partials(omp_get_max_threads(), PaddedValue<T>{ identity });
+    int team = 1;
+
+#pragma omp parallel
+    {
+        const size_t threads = omp_get_num_threads();
+        const size_t id = omp_get_thread_num();
+#pragma omp master
+        team = static_cast<int>(threads);
+        size_t begin = 0, end = 0;
+        static_range(count, threads, id, begin, end, grain);
+        if (begin < end) {
+            partials[id].value = block(begin, end);
+        }
+    }
+
+    T result = identity;
+    for (int id = 0; id < team; ++id) {
+        result = op(result, partials[id].value);
+    }
+    return result;
+}
+
+// Редукция элементов [first, last) операцией op: op(op(op(identity, x0), x1), ...)
+template <typename It, typename T, typename Op>
+T parallel_reduce(It first, It last, T identity, Op op) {
+    return parallel_reduce_blocks(static_cast<size_t>(last - first), identity,
+        [&](size_t begin, size_t end) {
+            T acc = identity;
+            for (size_t i = begin; i < end; ++i) {
+                acc = op(acc, first[i]);
+            }
+            return acc;
+        }, op);
+}
+
+template <typename Range, typename T, typename Op>
+T parallel_reduce(const Range& range, T identity, Op op) {
+    return parallel_reduce(std::begin(range), std::end(range), identity, op);
+}
+
+/*
+ * Включающая префиксная сумма: out[i] = in[0] op ... op in[i].
+ * Два прохода по участкам потоков: 1) редукция своего участка; 2) после
+ * последовательного префикса по частичным результатам каждый поток проходит
+ * свой участок еще раз, начиная с суммы предыдущих участков.
+ * out может совпадать с first (вычисление на месте).
+ */
+template <typename InIt, typename OutIt, typename Op>
+void parallel_scan(InIt first, InIt last, OutIt out, Op op) {
+    using T = typename std::iterator_traits<OutIt>::value_type;
+    const size_t count = static_cast<size_t>(last - first);
+    const int max_threads = omp_get_max_threads();
+    // Участок пуст у потоков с номером, большим числа элементов, поэтому нейтральный элемент не нужен
+    std::vector<PaddedValue<T>> partials(max_threads, PaddedValue<T>{ T() });
+    std::vector<PaddedValue<T>> carries(max_threads, PaddedValue<T>{ T() });
+    std::vector<PaddedValue<bool>> has_carry(max_threads, PaddedValue<bool>{ false });
+
+#pragma omp parallel
+    {
+        const size_t threads = omp_get_num_threads();
+        const size_t id = omp_get_thread_num();
+        size_t begin = 0, end = 0;
+        static_range(count, threads, id, begin, end);
+
+        if (begin < end) {
+            T acc = first[begin];
+            for (size_t i = begin + 1; i < end; ++i) {
+                acc = op(acc, first[i]);
+            }
+            partials[id].value = acc;
+        }
+#pragma omp barrier
+
+#pragma omp single
+        {
+            // Участки непусты подряд с начала, поэтому перенос есть у всех, кроме первого
+            for (size_t t = 1; t < threads; ++t) {
+                size_t previous_begin = 0, previous_end = 0;
+                static_range(count, threads, t - 1, previous_begin, previous_end);
+                if (previous_begin == previous_end) break;
+                carries[t].value = has_carry[t - 1].value ? op(carries[t - 1].value, partials[t - 1].value) : partials[t - 1].value;
+                has_carry[t].value = true;
+            }
+        }
+
+        if (begin < end) {
+            T acc = has_carry[id].value ? op(carries[id].value, first[begin]) : static_cast<T>(first[begin]);
+            out[begin] = acc;
+            for (size_t i = begin + 1; i < end; ++i) {
+                acc = op(acc, first[i]);
+                out[i] = acc;
+            }
+        }
+    }
+}
+
+template <typename In, typename Out, typename Op>
+void parallel_scan(const In& in, Out& out, Op op) {
+    parallel_scan(std::begin(in), std::end(in), std::begin(out), op);
+}
+
+/*
+ * Исключающая префиксная сумма: out[0] = identity, out[i] = in[0] op ... op in[i - 1].
+ * Тот же двухпроходный алгоритм; out может совпадать с first
+ */
+template <typename InIt, typename OutIt, typename T, typename Op>
+void parallel_exclusive_scan(InIt first, InIt last, OutIt out, T identity, Op op) {
+    const size_t count = static_cast<size_t>(last - first);
+    const int max_threads = omp_get_max_threads();
+    std::vector<PaddedValue<T>> partials(max_threads, PaddedValue<T>{ identity });
+
+#pragma omp parallel
+    {
+        const size_t threads = omp_get_num_threads();
+        const size_t id = omp_get_thread_num();
+        size_t begin = 0, end = 0;
+        static_range(count, threads, id, begin, end);
+
+        T acc = identity;
+        for (size_t i = begin; i < end; ++i) {
+            acc = op(acc, first[i]);
+        }
+        partials[id].value = acc;
+#pragma omp barrier
+
+#pragma omp single
+        {
+            // partials[t] заменяется суммой участков 0 .. t - 1
+            T running = identity;
+            for (size_t t = 0; t < threads; ++t) {
+                T next = op(running, partials[t].value);
+                partials[t].value = running;
+                running = next;
+            }
+        }
+
+        acc = partials[id].value;
+        for (size_t i = begin; i < end; ++i) {
+            T value = first[i];
+            out[i] = acc;
+            acc = op(acc, value);
+        }
+    }
+}
+
+template <typename In, typename Out, typename T, typename Op>
+void parallel_exclusive_scan(const In& in, Out& out, T identity, Op op) {
+    parallel_exclusive_scan(std::begin(in), std::end(in), std::begin(out), identity, op);
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+#include <algorithm>
+
+/*
+ * Участок [begin, end) потока id из threads при разбиении count элементов как в
+ * schedule(static): первые count % threads потоков получают на элемент больше.
+ * При grain > 1 распределяются группы по grain элементов, и границы участков
+ * кратны grain (например, 16 int - строка кэша).
+ * Единственное определение разбиения: по нему генераторы заполняют массивы,
+ * first_touch размещает страницы, а редукции читают данные, поэтому поток
+ * читает ровно те страницы, которых коснулся.
+ */
+inline void static_range(size_t count, size_t threads, size_t id, size_t& begin, size_t& end, size_t grain = 1) {
+    const size_t groups = (count + grain - 1) / grain;
+    const size_t first = groups / threads * id + std::min(id, groups % threads);
+    const size_t last = first + groups / threads + (id < groups % threads ? 1 : 0);
+    begin = std::min(count, first * grain);
+    end = std::min(count, last * grain);
+}
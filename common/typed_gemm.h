@@ -0,0 +1,249 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include "matrix.h"
+#include "cpu_features.h"
+
+/*
+ * Умножение матриц с типом элемента T и типом накопления Acc: C += A * B.
+ * Для float (накопление во float), int16 и int8 (накопление в int32) есть
+ * векторные ядра AVX2: в одном регистре 8 float или 16 пар int16, поэтому
+ * на один SIMD-шаг приходится в 2-8 раз больше элементов, чем у double,
+ * и во столько же раз меньше данных читается из памяти.
+ * Для остальных пар типов и процессоров без AVX2 - переносимое ядро.
+ */
+
+// Блок B: TYPED_KC строк (четное) x TYPED_NC столбцов (кратно 16);
+// ядро обновляет TYPED_MR строк C сразу, чтобы каждая загрузка B шла в TYPED_MR FMA
+const int TYPED_KC = 256;
+const int TYPED_NC = 1024;
+const int TYPED_MR = 4;
+
+/*
+ * Обновление rows (<= TYPED_MR) строк C: c[r][0..nc) += sum по p < kc a[r][p] * B[p][0..nc)
+ * b, ldb - блок B; для целочисленных ядер AVX2 он упакован парами строк
+ */
+template <typename T, typename Acc>
+using TypedBlockUpdate = void (*)(const T* a, size_t lda, int rows, const T* b, size_t ldb, Acc* c, size_t ldc, int kc, int nc);
+
+template <typename T, typename Acc>
+void row_update_scalar(const T* a, const T* b, size_t ldb, Acc* c, int kc, int nc) {
+    for (int p = 0; p < kc; ++p) {
+        const Acc value = static_cast<Acc>(a[p]);
+        const T* row = b + p * ldb;
+        for (int j = 0; j < nc; ++j) {
+            c[j] += value * static_cast<Acc>(row[j]);
+        }
+    }
+}
+
+template <typename T, typename Acc>
+void block_update_scalar(const T* a, size_t lda, int rows, const T* b, size_t ldb, Acc* c, size_t ldc, int kc, int nc) {
+    for (int r = 0; r < rows; ++r) {
+        row_update_scalar(a + r * lda, b, ldb, c + r * ldc, kc, nc);
+    }
+}
+
+/*
+ * Упаковка блока B (kc x nc) парами строк под pmaddwd:
+ * packed[q * ldp + 2 * j + t] = B[2q + t][j], недостающая строка - нули
+ */
+template <typename T>
+void pack_row_pairs(const T* b, size_t ldb, int kc, int nc, T* packed, size_t ldp) {
+    for (int q = 0; 2 * q < kc; ++q) {
+        const T* row0 = b + 2 * q * ldb;
+        const T* row1 = 2 * q + 1 < kc ? row0 + ldb : nullptr;
+        T* out = packed + q * ldp;
+        for (int j = 0; j < nc; ++j) {
+            out[2 * j] = row0[j];
+            out[2 * j + 1] = row1 ? row1[j] : T(0);
+        }
+    }
+}
+
+// Строки блока по упаковке парами (строки first .. rows, столбцы j0 .. nc)
+template <typename T>
+void block_update_pairs_scalar(const T* a, size_t lda, int first, int rows, const T* b, size_t ldp,
+    int32_t* c, size_t ldc, int kc, int j0, int nc) {
+    for (int r = first; r < rows; ++r) {
+        const T* ar = a + r * lda;
+        int32_t* cr = c + r * ldc;
+        for (int q = 0; 2 * q < kc; ++q) {
+            const int32_t a0 = ar[2 * q];
+            const int32_t a1 = 2 * q + 1 < kc ? ar[2 * q + 1] : 0;
+            const T* row = b + q * ldp;
+            for (int j = j0; j < nc; ++j) {
+                cr[j] += a0 * row[2 * j] + a1 * row[2 * j + 1];
+            }
+        }
+    }
+}
+
+#ifdef CPU_X86
+/*
+ * float: блок 4 x 16 элементов C в 8 регистрах, на каждом p - 2 загрузки B,
+ * 4 рассылки A и 8 FMA
+ */
+TARGET_AVX2 inline void block_update_f32_avx2(const float* a, size_t lda, int rows, const float* b, size_t ldb,
+    float* c, size_t ldc, int kc, int nc) {
+    if (rows < TYPED_MR) {
+        block_update_scalar<float, float>(a, lda, rows, b, ldb, c, ldc, kc, nc);
+        return;
+    }
+    const float *a0 = a, *a1 = a + lda, *a2 = a + 2 * lda, *a3 = a + 3 * lda;
+    float *c0 = c, *c1 = c + ldc, *c2 = c + 2 * ldc, *c3 = c + 3 * ldc;
+    int j = 0;
+    for (; j + 16 <= nc; j += 16) {
+        __m256 c00 = _mm256_loadu_ps(c0 + j), c01 = _mm256_loadu_ps(c0 + j + 8);
+        __m256 c10 = _mm256_loadu_ps(c1 + j), c11 = _mm256_loadu_ps(c1 + j + 8);
+        __m256 c20 = _mm256_loadu_ps(c2 + j), c21 = _mm256_loadu_ps(c2 + j + 8);
+        __m256 c30 = _mm256_loadu_ps(c3 + j), c31 = _mm256_loadu_ps(c3 + j + 8);
+        for (int p = 0; p < kc; ++p) {
+            const float* row = b + p * ldb + j;
+            const __m256 b0 = _mm256_loadu_ps(row), b1 = _mm256_loadu_ps(row + 8);
+            __m256 value;
+            value = _mm256_set1_ps(a0[p]); c00 = _mm256_fmadd_ps(value, b0, c00); c01 = _mm256_fmadd_ps(value, b1, c01);
+            value = _mm256_set1_ps(a1[p]); c10 = _mm256_fmadd_ps(value, b0, c10); c11 = _mm256_fmadd_ps(value, b1, c11);
+            value = _mm256_set1_ps(a2[p]); c20 = _mm256_fmadd_ps(value, b0, c20); c21 = _mm256_fmadd_ps(value, b1, c21);
+            value = _mm256_set1_ps(a3[p]); c30 = _mm256_fmadd_ps(value, b0, c30); c31 = _mm256_fmadd_ps(value, b1, c31);
+        }
+        _mm256_storeu_ps(c0 + j, c00); _mm256_storeu_ps(c0 + j + 8, c01);
+        _mm256_storeu_ps(c1 + j, c10); _mm256_storeu_ps(c1 + j + 8, c11);
+        _mm256_storeu_ps(c2 + j, c20); _mm256_storeu_ps(c2 + j + 8, c21);
+        _mm256_storeu_ps(c3 + j, c30); _mm256_storeu_ps(c3 + j + 8, c31);
+    }
+    if (j < nc) block_update_scalar<float, float>(a, lda, rows, b + j, ldb, c + j, ldc, kc, nc - j);
+}
+
+// Пара (a[2q], a[2q + 1]) как 32-битное слово для рассылки
+inline int32_t pack_pair(int a0, int a1) {
+    return static_cast<int32_t>(static_cast<uint16_t>(a0) | static_cast<uint32_t>(static_cast<uint16_t>(a1)) << 16);
+}
+
+// 16 столбцов (8 пар int16 на регистр) строк, упакованных парами, в int16
+TARGET_AVX2 inline __m256i load_pairs_i16(const int16_t* row) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row));
+}
+
+TARGET_AVX2 inline __m256i load_pairs_i16(const int8_t* row) {
+    return _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row)));
+}
+
+/*
+ * int16 / int8 -> int32: pmaddwd перемножает 16 пар int16 и складывает пары,
+ * то есть за одну инструкцию - 2 шага по k для 8 столбцов. int8 читается
+ * по байту на элемент и расширяется до int16 в регистре (pmovsxbw).
+ * Блок 4 x 16 элементов C в 8 регистрах.
+ */
+template <typename T>
+TARGET_AVX2 inline void block_update_pairs_avx2(const T* a, size_t lda, int rows, const T* b, size_t ldp,
+    int32_t* c, size_t ldc, int kc, int nc) {
+    if (rows < TYPED_MR) {
+        block_update_pairs_scalar(a, lda, 0, rows, b, ldp, c, ldc, kc, 0, nc);
+        return;
+    }
+    const T *a0 = a, *a1 = a + lda, *a2 = a + 2 * lda, *a3 = a + 3 * lda;
+    int32_t *c0 = c, *c1 = c + ldc, *c2 = c + 2 * ldc, *c3 = c + 3 * ldc;
+    const int pairs = (kc + 1) / 2; // Последняя пара при нечетном kc дополняется нулем
+    int j = 0;
+    for (; j + 16 <= nc; j += 16) {
+        __m256i c00 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c0 + j));
+        __m256i c01 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c0 + j + 8));
+        __m256i c10 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c1 + j));
+        __m256i c11 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c1 + j + 8));
+        __m256i c20 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c2 + j));
+        __m256i c21 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c2 + j + 8));
+        __m256i c30 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c3 + j));
+        __m256i c31 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c3 + j + 8));
+        for (int q = 0; q < pairs; ++q) {
+            const bool full = 2 * q + 1 < kc;
+            const T* row = b + q * ldp + 2 * j;
+            const __m256i b0 = load_pairs_i16(row), b1 = load_pairs_i16(row + 16);
+            __m256i pair;
+            pair = _mm256_set1_epi32(pack_pair(a0[2 * q], full ? a0[2 * q + 1] : 0));
+            c00 = _mm256_add_epi32(c00, _mm256_madd_epi16(pair, b0)); c01 = _mm256_add_epi32(c01, _mm256_madd_epi16(pair, b1));
+            pair = _mm256_set1_epi32(pack_pair(a1[2 * q], full ? a1[2 * q + 1] : 0));
+            c10 = _mm256_add_epi32(c10, _mm256_madd_epi16(pair, b0)); c11 = _mm256_add_epi32(c11, _mm256_madd_epi16(pair, b1));
+            pair = _mm256_set1_epi32(pack_pair(a2[2 * q], full ? a2[2 * q + 1] : 0));
+            c20 = _mm256_add_epi32(c20, _mm256_madd_epi16(pair, b0)); c21 = _mm256_add_epi32(c21, _mm256_madd_epi16(pair, b1));
+            pair = _mm256_set1_epi32(pack_pair(a3[2 * q], full ? a3[2 * q + 1] : 0));
+            c30 = _mm256_add_epi32(c30, _mm256_madd_epi16(pair, b0)); c31 = _mm256_add_epi32(c31, _mm256_madd_epi16(pair, b1));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(c0 + j), c00);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(c0 + j + 8), c01);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(c1 + j), c10);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(c1 + j + 8), c11);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(c2 + j), c20);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(c2 + j + 8), c21);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(c3 + j), c30);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(c3 + j + 8), c31);
+    }
+    if (j < nc) block_update_pairs_scalar(a, lda, 0, rows, b, ldp, c, ldc, kc, j, nc);
+}
+#endif
+
+// Ядро для пары типов: функция, нужна ли упаковка парами строк, название
+template <typename T, typename Acc>
+struct TypedKernel {
+    TypedBlockUpdate<T, Acc> update;
+    bool pairs;
+    const char* name;
+};
+
+template <typename T, typename Acc>
+TypedKernel<T, Acc> typed_kernel() {
+    return { block_update_scalar<T, Acc>, false, "скалярное" };
+}
+
+#ifdef CPU_X86
+template <>
+inline TypedKernel<float, float> typed_kernel<float, float>() {
+    if (cpu_features().avx2 && cpu_features().fma) return { block_update_f32_avx2, false, "AVX2/FMA" };
+    return { block_update_scalar<float, float>, false, "скалярное" };
+}
+
+template <>
+inline TypedKernel<int16_t, int32_t> typed_kernel<int16_t, int32_t>() {
+    if (cpu_features().avx2) return { block_update_pairs_avx2<int16_t>, true, "AVX2 pmaddwd" };
+    return { block_update_scalar<int16_t, int32_t>, false, "скалярное" };
+}
+
+template <>
+inline TypedKernel<int8_t, int32_t> typed_kernel<int8_t, int32_t>() {
+    if (cpu_features().avx2) return { block_update_pairs_avx2<int8_t>, true, "AVX2 pmovsxbw + pmaddwd" };
+    return { block_update_scalar<int8_t, int32_t>, false, "скалярное" };
+}
+#endif
+
+/*
+ * C (m x n, ldc) += A (m x k, lda) * B (k x n, ldb).
+ * Блоки B TYPED_KC x TYPED_NC переиспользуются всеми строками A из кэша,
+ * группы по TYPED_MR строк A распределяются между потоками OpenMP.
+ */
+template <typename T, typename Acc>
+void gemm_typed(int m, int n, int k, const T* A, size_t lda, const T* B, size_t ldb, Acc* C, size_t ldc) {
+    const TypedKernel<T, Acc> kernel = typed_kernel<T, Acc>();
+    const size_t ldp = 2 * static_cast<size_t>(TYPED_NC);
+    Matrix<T> packed(kernel.pairs ? TYPED_KC / 2 : 0, ldp);
+
+    for (int jc = 0; jc < n; jc += TYPED_NC) {
+        const int nc = std::min(TYPED_NC, n - jc);
+        for (int pc = 0; pc < k; pc += TYPED_KC) {
+            const int kc = std::min(TYPED_KC, k - pc);
+            const T* block = B + pc * ldb + jc;
+            size_t ld_block = ldb;
+            if (kernel.pairs) {
+                pack_row_pairs(block, ldb, kc, nc, packed.data(), packed.ld());
+                block = packed.data();
+                ld_block = packed.ld();
+            }
+
+#pragma omp parallel for schedule(static)
+            for (int i = 0; i < m; i += TYPED_MR) {
+                kernel.update(A + i * lda + pc, lda, std::min(TYPED_MR, m - i), block, ld_block, C + i * ldc + jc, ldc, kc, nc);
+            }
+        }
+    }
+}
@@ -3,83 +3,895 @@
 #include <thread>
 #include <vector>
 #include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <random>
+#include <string>
+#include <algorithm>
+#include <cstdint>
+#include <cmath>
 #include <cassert>
+#include <limits>
 #include <windows.h>
 #include <locale>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
 
-// Последовательное вычисление факториала
-unsigned long long sequential_factorial(int n) {
-    if (n < 0) return 0;
-    unsigned long long result = 1;
-    for (int i = 1; i <= n; ++i) {
-        result *= i;
+// Порог (в 32-битных словах), ниже которого умножение выполняется "в столбик"
+const size_t KARATSUBA_THRESHOLD = 64;
+
+// Размер листа дерева произведений: столько множителей перемножается подряд
+const uint32_t PRODUCT_TREE_LEAF = 16;
+
+/*
+ * Длинное беззнаковое целое число.
+ * Хранится как массив 32-битных слов (limbs), младшие слова идут первыми,
+ * старших нулевых слов нет (ноль - пустой массив).
+ */
+struct BigInt {
+    std::vector<uint32_t> limbs;
+
+    BigInt(uint32_t value = 0) {
+        if (value != 0) limbs.push_back(value);
+    }
+
+    // Удаление старших нулевых слов
+    void trim() {
+        while (!limbs.empty() && limbs.back() == 0) limbs.pop_back();
+    }
+
+    // Умножение на короткое число "на месте"
+    void mul_small(uint32_t m) {
+        uint64_t carry = 0;
+        for (auto& limb : limbs) {
+            uint64_t t = static_cast<uint64_t>(limb) * m + carry;
+            limb = static_cast<uint32_t>(t);
+            carry = t >> 32;
+        }
+        if (carry != 0) limbs.push_back(static_cast<uint32_t>(carry));
+        if (m == 0) limbs.clear();
+    }
+
+    // Сдвиг влево на shift бит (умножение на 2^shift)
+    void shift_left(size_t shift) {
+        if (limbs.empty()) return;
+        size_t words = shift / 32;
+        unsigned bits = shift % 32;
+        if (bits != 0) {
+            uint32_t carry = 0;
+            for (auto& limb : limbs) {
+                uint32_t next = limb >> (32 - bits);
+                limb = (limb << bits) | carry;
+                carry = next;
+            }
+            if (carry != 0) limbs.push_back(carry);
+        }
+        limbs.insert(limbs.begin(), words, 0u);
+    }
+
+    // Количество значащих бит
+    size_t bit_length() const {
+        if (limbs.empty()) return 0;
+        size_t bits = (limbs.size() - 1) * 32;
+        for (uint32_t top = limbs.back(); top != 0; top >>= 1) ++bits;
+        return bits;
+    }
+
+    // Десятичная запись (квадратичный алгоритм - только для небольших чисел)
+    std::string to_string() const {
+        if (limbs.empty()) return "0";
+
+        std::vector<uint32_t> rest = limbs;
+        std::vector<uint32_t> chunks; // Группы по 9 десятичных цифр, младшие первыми
+        while (!rest.empty()) {
+            uint64_t remainder = 0;
+            for (size_t i = rest.size(); i-- > 0;) {
+                uint64_t cur = (remainder << 32) | rest[i];
+                rest[i] = static_cast<uint32_t>(cur / 1000000000u);
+                remainder = cur % 1000000000u;
+            }
+            chunks.push_back(static_cast<uint32_t>(remainder));
+            while (!rest.empty() && rest.back() == 0) rest.pop_back();
+        }
+
+        std::string result = std::to_string(chunks.back());
+        for (size_t i = chunks.size() - 1; i-- > 0;) {
+            std::string part = std::to_string(chunks[i]);
+            result += std::string(9 - part.size(), '0') + part;
+        }
+        return result;
+    }
+
+    friend bool operator==(const BigInt& a, const BigInt& b) { return a.limbs == b.limbs; }
+    friend bool operator!=(const BigInt& a, const BigInt& b) { return !(a == b); }
+};
+
+/*
+ * Постоянный пул потоков: потоки создаются один раз и ждут заданий.
+ * run(count, task) выполняет task(0) ... task(count - 1) и возвращает управление,
+ * когда все индексы обработаны. Вызывающий поток сам берет задачи своей пачки
+ * (и более новых вложенных), поэтому run можно вызывать из задач пула.
+ */
+class ThreadPool {
+public:
+    explicit ThreadPool(int workers) {
+        for (int i = 0; i < workers; ++i) {
+            threads.emplace_back([this] { worker_loop(); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Количество потоков, выполняющих задачи (включая вызывающий)
+    int size() const { return static_cast<int>(threads.size()) + 1; }
+
+    template <typename Task>
+    void run(size_t count, Task&& task) {
+        if (count == 0) return;
+        if (count == 1 || threads.empty()) {
+            for (size_t i = 0; i < count; ++i) task(i);
+            return;
+        }
+
+        using TaskType = typename std::remove_reference<Task>::type;
+        Batch batch;
+        batch.invoke = [](void* context, size_t index) { (*static_cast<TaskType*>(context))(index); };
+        batch.context = &task;
+        batch.count = count;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            batch.id = ++last_id;
+            active.push_back(&batch);
+        }
+        wake.notify_all();
+
+        while (batch.done.load(std::memory_order_acquire) < count) {
+            if (run_one(batch.id)) continue;
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] {
+                return batch.done.load(std::memory_order_acquire) == count
+                    || (!active.empty() && active.back()->id >= batch.id);
+                });
+        }
+    }
+
+private:
+    // Пачка задач одного вызова run; живет на стеке вызывающего потока
+    struct Batch {
+        void (*invoke)(void* context, size_t index) = nullptr;
+        void* context = nullptr;
+        size_t count = 0;
+        size_t next = 0; // Следующий невыданный индекс (под mutex)
+        uint64_t id = 0;
+        std::atomic<size_t> done{ 0 };
+    };
+
+    // Выполняет одну задачу самой новой пачки с id >= min_id
+    bool run_one(uint64_t min_id) {
+        Batch* batch;
+        size_t index;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (active.empty() || active.back()->id < min_id) return false;
+            batch = active.back();
+            index = batch->next++;
+            if (batch->next == batch->count) active.pop_back();
+        }
+
+        size_t count = batch->count;
+        batch->invoke(batch->context, index);
+        // После увеличения done пачка может быть уже уничтожена владельцем
+        if (batch->done.fetch_add(1, std::memory_order_acq_rel) + 1 == count) {
+            std::lock_guard<std::mutex> lock(mutex);
+            wake.notify_all();
+        }
+        return true;
+    }
+
+    void worker_loop() {
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [this] { return stopping || !active.empty(); });
+                if (stopping && active.empty()) return;
+            }
+            run_one(0);
+        }
+    }
+
+    std::vector<std::thread> threads;
+    std::vector<Batch*> active; // Пачки с невыданными задачами, новые в конце
+    std::mutex mutex;
+    std::condition_variable wake;
+    uint64_t last_id = 0;
+    bool stopping = false;
+};
+
+// Общий пул на все ядра (вызывающий поток - одно из них)
+ThreadPool& shared_pool() {
+    static ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+    return pool;
+}
+
+/*
+ * r[0..rn) += x[0..xn), перенос распространяется до конца r
+ */
+void add_into(uint32_t* r, size_t rn, const uint32_t* x, size_t xn) {
+    uint64_t carry = 0;
+    size_t i = 0;
+    for (; i < xn; ++i) {
+        uint64_t t = static_cast<uint64_t>(r[i]) + x[i] + carry;
+        r[i] = static_cast<uint32_t>(t);
+        carry = t >> 32;
     }
+    for (; carry != 0 && i < rn; ++i) {
+        uint64_t t = static_cast<uint64_t>(r[i]) + carry;
+        r[i] = static_cast<uint32_t>(t);
+        carry = t >> 32;
+    }
+    assert(carry == 0);
+}
+
+/*
+ * z[0..zn) -= x[0..xn), результат обязан быть неотрицательным
+ */
+void sub_from(uint32_t* z, size_t zn, const uint32_t* x, size_t xn) {
+    int64_t borrow = 0;
+    size_t i = 0;
+    for (; i < xn; ++i) {
+        int64_t t = static_cast<int64_t>(z[i]) - x[i] - borrow;
+        borrow = t < 0;
+        z[i] = static_cast<uint32_t>(t);
+    }
+    for (; borrow != 0 && i < zn; ++i) {
+        int64_t t = static_cast<int64_t>(z[i]) - borrow;
+        borrow = t < 0;
+        z[i] = static_cast<uint32_t>(t);
+    }
+    assert(borrow == 0);
+}
+
+// Длина числа без старших нулевых слов
+size_t significant_length(const uint32_t* x, size_t n) {
+    while (n > 0 && x[n - 1] == 0) --n;
+    return n;
+}
+
+/*
+ * Умножение "в столбик": r[0..na+nb) = a * b
+ */
+void mul_schoolbook(const uint32_t* a, size_t na, const uint32_t* b, size_t nb, uint32_t* r) {
+    std::fill(r, r + na + nb, 0u);
+    for (size_t i = 0; i < na; ++i) {
+        uint64_t ai = a[i];
+        if (ai == 0) continue;
+        uint64_t carry = 0;
+        for (size_t j = 0; j < nb; ++j) {
+            uint64_t t = ai * b[j] + r[i + j] + carry;
+            r[i + j] = static_cast<uint32_t>(t);
+            carry = t >> 32;
+        }
+        r[i + nb] = static_cast<uint32_t>(carry);
+    }
+}
+
+/*
+ * Умножение Карацубы: r[0..na+nb) = a * b
+ * parallel_depth - сколько верхних уровней рекурсии считать в отдельных потоках
+ * (три подпроизведения одного уровня независимы)
+ */
+void mul_karatsuba(const uint32_t* a, size_t na, const uint32_t* b, size_t nb, uint32_t* r, int parallel_depth) {
+    if (na < nb) {
+        std::swap(a, b);
+        std::swap(na, nb);
+    }
+    if (nb < KARATSUBA_THRESHOLD) {
+        mul_schoolbook(a, na, b, nb, r);
+        return;
+    }
+
+    // Сильно несбалансированные сомножители: режем длинный на куски длины nb
+    if (na >= 2 * nb) {
+        std::fill(r, r + na + nb, 0u);
+        std::vector<uint32_t> piece(2 * nb);
+        for (size_t offset = 0; offset < na; offset += nb) {
+            size_t len = std::min(nb, na - offset);
+            mul_karatsuba(a + offset, len, b, nb, piece.data(), 0);
+            add_into(r + offset, na + nb - offset, piece.data(), significant_length(piece.data(), len + nb));
+        }
+        return;
+    }
+
+    // a = a1 * B^m + a0, b = b1 * B^m + b0 (m < nb, т.к. na < 2 * nb)
+    size_t m = na / 2;
+    const uint32_t* a0 = a;
+    const uint32_t* a1 = a + m;
+    const uint32_t* b0 = b;
+    const uint32_t* b1 = b + m;
+    size_t na1 = na - m;
+    size_t nb1 = nb - m;
+
+    // Суммы половин: sa = a0 + a1, sb = b0 + b1
+    std::vector<uint32_t> sa(std::max(m, na1) + 1, 0u);
+    std::vector<uint32_t> sb(std::max(m, nb1) + 1, 0u);
+    std::copy(a1, a1 + na1, sa.begin());
+    add_into(sa.data(), sa.size(), a0, m);
+    std::copy(b1, b1 + nb1, sb.begin());
+    add_into(sb.data(), sb.size(), b0, m);
+
+    std::vector<uint32_t> z1(sa.size() + sb.size());
+    uint32_t* z0 = r;           // a0 * b0 занимает r[0..2m)
+    uint32_t* z2 = r + 2 * m;   // a1 * b1 занимает r[2m..na+nb)
+
+    if (parallel_depth > 0) {
+        shared_pool().run(3, [&](size_t part) {
+            if (part == 0) mul_karatsuba(a0, m, b0, m, z0, parallel_depth - 1);
+            else if (part == 1) mul_karatsuba(a1, na1, b1, nb1, z2, parallel_depth - 1);
+            else mul_karatsuba(sa.data(), sa.size(), sb.data(), sb.size(), z1.data(), parallel_depth - 1);
+            });
+    }
+    else {
+        mul_karatsuba(a0, m, b0, m, z0, 0);
+        mul_karatsuba(a1, na1, b1, nb1, z2, 0);
+        mul_karatsuba(sa.data(), sa.size(), sb.data(), sb.size(), z1.data(), 0);
+    }
+
+    // z1 = (a0 + a1)(b0 + b1) - z0 - z2 = a0 * b1 + a1 * b0
+    sub_from(z1.data(), z1.size(), z0, 2 * m);
+    sub_from(z1.data(), z1.size(), z2, na1 + nb1);
+    add_into(r + m, na + nb - m, z1.data(), significant_length(z1.data(), z1.size()));
+}
+
+// Произведение двух длинных чисел
+BigInt multiply(const BigInt& a, const BigInt& b, int parallel_depth = 0) {
+    BigInt result;
+    if (a.limbs.empty() || b.limbs.empty()) return result;
+    result.limbs.resize(a.limbs.size() + b.limbs.size());
+    mul_karatsuba(a.limbs.data(), a.limbs.size(), b.limbs.data(), b.limbs.size(),
+        result.limbs.data(), parallel_depth);
+    result.trim();
     return result;
 }
 
-// Параллельное вычисление факториала
-unsigned long long parallel_factorial(int n, int num_threads) {
-    if (n < 0) return 0;
-    if (n < 2) return 1;
+/*
+ * Произведение чисел диапазона [lo, hi] сбалансированным деревом:
+ * соседние половины перемножаются рекурсивно, поэтому на верхних уровнях
+ * сомножители имеют близкую длину и умножение Карацубы работает эффективно
+ */
+BigInt range_product(uint32_t lo, uint32_t hi) {
+    if (lo > hi) return BigInt(1);
+    if (hi - lo < PRODUCT_TREE_LEAF) {
+        BigInt result(1);
+        for (uint64_t i = lo; i <= hi; ++i) {
+            result.mul_small(static_cast<uint32_t>(i));
+        }
+        return result;
+    }
+    uint32_t mid = lo + (hi - lo) / 2;
+    return multiply(range_product(lo, mid), range_product(mid + 1, hi));
+}
 
-    unsigned long long result = 1;
-    std::mutex result_mutex;
-    std::vector<std::thread> threads;
+// Произведение списка множителей factors[lo..hi) тем же деревом, что и range_product
+BigInt list_product(const std::vector<uint32_t>& factors, size_t lo, size_t hi) {
+    if (hi - lo <= PRODUCT_TREE_LEAF) {
+        BigInt result(1);
+        for (size_t i = lo; i < hi; ++i) {
+            result.mul_small(factors[i]);
+        }
+        return result;
+    }
+    size_t mid = lo + (hi - lo) / 2;
+    return multiply(list_product(factors, lo, mid), list_product(factors, mid, hi));
+}
 
-    int chunk_size = n / num_threads;
-    int remainder = n % num_threads;
+// Глубина параллельной рекурсии Карацубы, при которой занято не меньше num_threads потоков
+int karatsuba_depth_for(int num_threads) {
+    int depth = 0;
+    for (int busy = 1; busy < num_threads; busy *= 3) ++depth;
+    return depth;
+}
 
-    auto worker = [&result, &result_mutex](int start, int end) {
-        unsigned long long partial = 1;
-        for (int i = start; i <= end; ++i) {
-            partial *= i;
+/*
+ * Попарное перемножение частичных произведений (верхние уровни дерева).
+ * Пары одного уровня считаются задачами пула; последнее, самое
+ * большое умножение распараллеливается внутри алгоритма Карацубы.
+ */
+BigInt combine_products(std::vector<BigInt> partials, int num_threads) {
+    if (partials.empty()) return BigInt(1);
+
+    while (partials.size() > 1) {
+        size_t pairs = partials.size() / 2;
+        std::vector<BigInt> next(pairs + partials.size() % 2);
+
+        if (pairs == 1) {
+            next[0] = multiply(partials[0], partials[1], karatsuba_depth_for(num_threads));
+        }
+        else {
+            shared_pool().run(pairs, [&partials, &next](size_t i) {
+                next[i] = multiply(partials[2 * i], partials[2 * i + 1]);
+                });
         }
+        if (partials.size() % 2 != 0) {
+            next.back() = std::move(partials.back());
+        }
+        partials = std::move(next);
+    }
+    return std::move(partials[0]);
+}
+
+// Последовательное вычисление факториала
+BigInt sequential_factorial(int n) {
+    if (n < 0) return BigInt(0);
+    BigInt result(1);
+    for (int i = 2; i <= n; ++i) {
+        result.mul_small(static_cast<uint32_t>(i));
+    }
+    return result;
+}
+
+// Порог n, ниже которого parallel_factorial считает в вызывающем потоке
+// (уточняется calibrate_parallel_cutoff при запуске программы)
+int g_parallel_cutoff = 4096;
 
-        std::lock_guard<std::mutex> lock(result_mutex);
-        result *= partial;
-        };
+/*
+ * Факториал на пуле: диапазон [1, n] делится на num_threads кусков, каждая
+ * задача пишет дерево произведений своего куска в собственную ячейку partials,
+ * ячейки объединяются после run без блокировок
+ */
+BigInt pooled_factorial(int n, int num_threads) {
+    if (num_threads > n) num_threads = n;
 
-    int start = 1;
+    std::vector<BigInt> partials(num_threads);
+
+    int chunk_size = n / num_threads;
+    int remainder = n % num_threads;
+
+    std::vector<int> starts(num_threads + 1);
+    starts[0] = 1;
     for (int i = 0; i < num_threads; ++i) {
-        int end = start + chunk_size - 1;
+        int end = starts[i] + chunk_size - 1;
         if (i < remainder) {
             end += 1;
         }
         if (end > n) end = n;
+        starts[i + 1] = end + 1;
+    }
+
+    shared_pool().run(num_threads, [&partials, &starts](size_t i) {
+        partials[i] = range_product(starts[i], starts[i + 1] - 1);
+        });
+
+    return combine_products(std::move(partials), num_threads);
+}
+
+// Параллельное вычисление факториала
+BigInt parallel_factorial(int n, int num_threads) {
+    if (n < 0) return BigInt(0);
+    if (n < 2) return BigInt(1);
+
+    // Малые n: запуск задач дороже самой работы, считаем деревом в текущем потоке
+    if (num_threads < 2 || n < g_parallel_cutoff) return range_product(2, n);
+
+    return pooled_factorial(n, num_threads);
+}
+
+// Параллельное произведение списка множителей (разбиение как в parallel_factorial)
+BigInt parallel_list_product(const std::vector<uint32_t>& factors, int num_threads) {
+    size_t count = factors.size();
+    if (count <= PRODUCT_TREE_LEAF || num_threads < 2) return list_product(factors, 0, count);
+    if (static_cast<size_t>(num_threads) > count) num_threads = static_cast<int>(count);
+
+    std::vector<BigInt> partials(num_threads);
+
+    size_t chunk_size = count / num_threads;
+    size_t remainder = count % num_threads;
+
+    shared_pool().run(num_threads, [&](size_t i) {
+        size_t start = i * chunk_size + std::min(i, remainder);
+        size_t end = start + chunk_size + (i < remainder ? 1 : 0);
+        partials[i] = list_product(factors, start, end);
+        });
+
+    return combine_products(std::move(partials), num_threads);
+}
+
+// Размер сегмента решета (в числах), сегмент целиком помещается в кэш L2
+const uint32_t SIEVE_SEGMENT = 1u << 18;
+
+/*
+ * Параллельное сегментированное решето Эратосфена: все простые <= n.
+ * Базовые простые до sqrt(n) находятся обычным решетом, затем сегменты
+ * распределяются между задачами пула по кругу; каждый сегмент пишет свои простые
+ * в отдельный список, поэтому после объединения порядок возрастающий.
+ */
+std::vector<uint32_t> primes_up_to(uint32_t n, int num_threads) {
+    std::vector<uint32_t> primes;
+    if (n < 2) return primes;
+
+    uint32_t root = static_cast<uint32_t>(std::sqrt(static_cast<double>(n)));
+    while (static_cast<uint64_t>(root + 1) * (root + 1) <= n) ++root;
+    while (static_cast<uint64_t>(root) * root > n) --root;
+
+    std::vector<char> small_composite(root + 1, 0);
+    std::vector<uint32_t> base_primes;
+    for (uint32_t i = 2; i <= root; ++i) {
+        if (small_composite[i]) continue;
+        base_primes.push_back(i);
+        for (uint64_t j = static_cast<uint64_t>(i) * i; j <= root; j += i) {
+            small_composite[j] = 1;
+        }
+    }
+
+    size_t segments = (static_cast<size_t>(n) + 1 + SIEVE_SEGMENT - 1) / SIEVE_SEGMENT;
+    std::vector<std::vector<uint32_t>> found(segments);
+    if (num_threads < 1) num_threads = 1;
+    if (static_cast<size_t>(num_threads) > segments) num_threads = static_cast<int>(segments);
+
+    shared_pool().run(num_threads, [&](size_t index) {
+        std::vector<char> composite(SIEVE_SEGMENT);
+        for (size_t seg = index; seg < segments; seg += num_threads) {
+            uint64_t low = static_cast<uint64_t>(seg) * SIEVE_SEGMENT;
+            uint64_t high = std::min<uint64_t>(low + SIEVE_SEGMENT, static_cast<uint64_t>(n) + 1);
+            std::fill(composite.begin(), composite.end(), 0);
+
+            for (uint32_t p : base_primes) {
+                uint64_t first = std::max<uint64_t>(static_cast<uint64_t>(p) * p, (low + p - 1) / p * p);
+                for (uint64_t j = first; j < high; j += p) {
+                    composite[j - low] = 1;
+                }
+            }
+            for (uint64_t i = std::max<uint64_t>(low, 2); i < high; ++i) {
+                if (!composite[i - low]) found[seg].push_back(static_cast<uint32_t>(i));
+            }
+        }
+        });
+
+    for (const auto& segment : found) {
+        primes.insert(primes.end(), segment.begin(), segment.end());
+    }
+    return primes;
+}
+
+// Показатель степени простого p в разложении n! (формула Лежандра)
+uint64_t legendre_exponent(uint32_t n, uint32_t p) {
+    uint64_t exponent = 0;
+    for (uint64_t power = p; power <= n; power *= p) {
+        exponent += n / power;
+    }
+    return exponent;
+}
+
+/*
+ * Факториал через разложение на простые множители:
+ * n! = 2^e(2) * П p^e(p). Нечетные простые группируются по битам показателя:
+ * P_k - произведение простых, у которых в e(p) установлен бит k, тогда
+ * П p^e(p) = П P_k^(2^k) и вычисляется схемой Горнера с возведением в квадрат.
+ * Каждое P_k считается параллельным деревом произведений, степень двойки - сдвигом.
+ */
+BigInt prime_factorial(int n, int num_threads) {
+    if (n < 0) return BigInt(0);
+    if (n < 2) return BigInt(1);
+
+    std::vector<uint32_t> primes = primes_up_to(static_cast<uint32_t>(n), num_threads);
+
+    std::vector<std::vector<uint32_t>> by_bit;
+    for (size_t i = 1; i < primes.size(); ++i) {
+        uint64_t exponent = legendre_exponent(n, primes[i]);
+        for (size_t bit = 0; exponent != 0; ++bit, exponent >>= 1) {
+            if (bit >= by_bit.size()) by_bit.resize(bit + 1);
+            if (exponent & 1) by_bit[bit].push_back(primes[i]);
+        }
+    }
+
+    BigInt result(1);
+    int depth = karatsuba_depth_for(num_threads);
+    for (size_t bit = by_bit.size(); bit-- > 0;) {
+        result = multiply(result, result, depth);
+        result = multiply(result, parallel_list_product(by_bit[bit], num_threads), depth);
+    }
+    result.shift_left(legendre_exponent(n, 2));
+    return result;
+}
+
+// Старшие 64 бита произведения a * b (младшие возвращаются)
+inline uint64_t mul_wide(uint64_t a, uint64_t b, uint64_t* high) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    return _umul128(a, b, high);
+#else
+    unsigned __int128 t = static_cast<unsigned __int128>(a) * b;
+    *high = static_cast<uint64_t>(t >> 64);
+    return static_cast<uint64_t>(t);
+#endif
+}
+
+// a * b mod m для произвольного 64-битного модуля (a, b < m)
+inline uint64_t mul_mod(uint64_t a, uint64_t b, uint64_t m) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    uint64_t high;
+    uint64_t low = _umul128(a, b, &high);
+    uint64_t remainder;
+    _udiv128(high, low, m, &remainder);
+    return remainder;
+#else
+    return static_cast<uint64_t>(static_cast<unsigned __int128>(a) * b % m);
+#endif
+}
+
+/*
+ * Арифметика Монтгомери по нечетному модулю m < 2^63:
+ * умножение по модулю без деления, числа хранятся в виде x * 2^64 mod m
+ */
+struct Montgomery {
+    uint64_t m;
+    uint64_t neg_inv; // -m^(-1) mod 2^64
+    uint64_t r2;      // 2^128 mod m
+    uint64_t one;     // 2^64 mod m, единица в представлении Монтгомери
+
+    explicit Montgomery(uint64_t modulus) : m(modulus) {
+        uint64_t inv = m; // Верно в 3 младших битах, итерации Ньютона удваивают точность
+        for (int i = 0; i < 5; ++i) inv *= 2 - m * inv;
+        neg_inv = 0 - inv;
+        one = (0 - m) % m;
+        r2 = mul_mod(one, one, m);
+    }
 
-        threads.emplace_back(worker, start, end);
-        start = end + 1;
+    uint64_t reduce(uint64_t high, uint64_t low) const {
+        uint64_t q = low * neg_inv;
+        uint64_t t_high;
+        uint64_t t_low = mul_wide(q, m, &t_high);
+        uint64_t result = high + t_high + (low + t_low < low ? 1 : 0);
+        return result >= m ? result - m : result;
     }
 
-    for (auto& thread : threads) {
-        thread.join();
+    uint64_t mul(uint64_t a, uint64_t b) const {
+        uint64_t high;
+        uint64_t low = mul_wide(a, b, &high);
+        return reduce(high, low);
     }
 
+    uint64_t to(uint64_t x) const { return mul(x % m, r2); }
+    uint64_t from(uint64_t x) const { return reduce(0, x); }
+};
+
+// Произведение чисел [lo, hi] по модулю m (последовательно)
+uint64_t range_product_mod(uint64_t lo, uint64_t hi, uint64_t m) {
+    if (m == 1) return 0;
+    if (m % 2 == 0 || m >= (1ull << 63)) {
+        uint64_t result = 1;
+        for (uint64_t i = lo; i <= hi; ++i) {
+            result = mul_mod(result, i % m, m);
+        }
+        return result;
+    }
+
+    // Множители тоже держим в представлении Монтгомери и увеличиваем сложением.
+    // Четыре независимые цепочки умножений скрывают задержку mul_wide.
+    Montgomery mont(m);
+    uint64_t step = mont.to(4);
+    uint64_t acc[4];
+    uint64_t factor[4];
+    for (int k = 0; k < 4; ++k) {
+        acc[k] = mont.one;
+        factor[k] = mont.to(lo + k);
+    }
+
+    uint64_t i = lo;
+    for (; i <= hi && hi - i >= 3; i += 4) {
+        for (int k = 0; k < 4; ++k) {
+            acc[k] = mont.mul(acc[k], factor[k]);
+            factor[k] += step;
+            if (factor[k] >= m) factor[k] -= m;
+        }
+    }
+    for (int k = 0; i <= hi; ++i, ++k) {
+        acc[k] = mont.mul(acc[k], factor[k]);
+    }
+
+    uint64_t result = mont.mul(mont.mul(acc[0], acc[1]), mont.mul(acc[2], acc[3]));
+    return mont.from(result);
+}
+
+/*
+ * n! mod p. При n >= p ответ 0 (p входит в произведение), иначе диапазон
+ * [1, n] делится на сегменты между задачами пула, как в parallel_factorial,
+ * а частичные остатки перемножаются после run без блокировок.
+ */
+uint64_t factorial_mod(uint64_t n, uint64_t p, int num_threads) {
+    if (p == 0) return 0;
+    if (n >= p) return 0;
+    if (n < 2) return 1 % p;
+    if (num_threads < 1) num_threads = 1;
+    if (static_cast<uint64_t>(num_threads) > n) num_threads = static_cast<int>(n);
+
+    std::vector<uint64_t> partials(num_threads, 1);
+
+    uint64_t chunk_size = n / num_threads;
+    uint64_t remainder = n % num_threads;
+
+    shared_pool().run(num_threads, [&](size_t i) {
+        uint64_t start = 1 + i * chunk_size + std::min<uint64_t>(i, remainder);
+        uint64_t end = start + chunk_size - 1 + (i < remainder ? 1 : 0);
+        partials[i] = range_product_mod(start, end, p);
+        });
+
+    uint64_t result = 1 % p;
+    for (uint64_t partial : partials) {
+        result = mul_mod(result, partial, p);
+    }
     return result;
 }
 
+// Медианное время (в секундах) нескольких запусков fn
+template <typename Fn>
+double median_time(Fn fn, int repeats = 5) {
+    std::vector<double> times;
+    for (int i = 0; i < repeats; ++i) {
+        auto start = std::chrono::high_resolution_clock::now();
+        fn();
+        auto end = std::chrono::high_resolution_clock::now();
+        times.push_back(std::chrono::duration<double>(end - start).count());
+    }
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+/*
+ * Калибровка порога g_parallel_cutoff: для n = 64, 128, ... сравнивается
+ * расчет в текущем потоке и расчет на пуле. Порог - первое n, начиная с
+ * которого пул быстрее на двух соседних размерах подряд.
+ */
+int calibrate_parallel_cutoff(int num_threads) {
+    const int max_n = 1 << 16;
+
+    if (num_threads < 2 || shared_pool().size() < 2) {
+        g_parallel_cutoff = std::numeric_limits<int>::max();
+        return g_parallel_cutoff;
+    }
+
+    pooled_factorial(1000, num_threads); // Прогрев пула
+    int candidate = 0;
+    for (int n = 64; n <= max_n; n *= 2) {
+        double inline_time = median_time([n] { range_product(2, n); });
+        double pooled_time = median_time([n, num_threads] { pooled_factorial(n, num_threads); });
+        if (pooled_time < inline_time) {
+            if (candidate != 0) {
+                g_parallel_cutoff = candidate;
+                return g_parallel_cutoff;
+            }
+            candidate = n;
+        }
+        else {
+            candidate = 0;
+        }
+    }
+    g_parallel_cutoff = candidate != 0 ? candidate : 2 * max_n;
+    return g_parallel_cutoff;
+}
+
+// Краткое описание длинного числа: полностью, если оно короткое, иначе - длина в битах
+std::string describe(const BigInt& value) {
+    if (value.bit_length() <= 256) return value.to_string();
+    return "<" + std::to_string(value.bit_length()) + " бит>";
+}
+
+// Параллельная реализация факториала: все варианты имеют одинаковую сигнатуру
+struct FactorialBackend {
+    const char* name;
+    BigInt (*compute)(int n, int num_threads);
+};
+
+const FactorialBackend FACTORIAL_BACKENDS[] = {
+    { "дерево произведений", parallel_factorial },
+    { "разложение на простые", prime_factorial },
+};
+
+/*
+ * Сравнение последовательного цикла и параллельных реализаций
+ * для n = 10^4 ... 10^6
+ */
+void benchmark_factorial(int num_threads) {
+    const int sizes[] = { 10000, 100000, 1000000 };
+
+    std::cout << "Бенчмарк (" << num_threads << " потоков):\n";
+    for (int n : sizes) {
+        auto start_seq = std::chrono::high_resolution_clock::now();
+        BigInt seq_result = sequential_factorial(n);
+        auto end_seq = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> seq_duration = end_seq - start_seq;
+
+        std::cout << "n = " << n << " (" << seq_result.bit_length() << " бит): "
+            << "последовательно " << seq_duration.count() << " с\n";
+
+        for (const auto& backend : FACTORIAL_BACKENDS) {
+            auto start_par = std::chrono::high_resolution_clock::now();
+            BigInt par_result = backend.compute(n, num_threads);
+            auto end_par = std::chrono::high_resolution_clock::now();
+            std::chrono::duration<double> par_duration = end_par - start_par;
+
+            std::cout << "  " << backend.name << ": " << par_duration.count() << " с, "
+                << "ускорение " << seq_duration.count() / par_duration.count() << "x, "
+                << (seq_result == par_result ? "совпадают" : "НЕ СОВПАДАЮТ") << "\n";
+        }
+    }
+}
+
+/*
+ * Повторные вызовы для смешанных n: суммарное время parallel_factorial
+ * не должно превышать время sequential_factorial
+ */
+void benchmark_mixed_calls(int num_threads) {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> log_n(0.0, std::log(30000.0));
+    std::vector<int> values(300);
+    for (auto& value : values) {
+        value = static_cast<int>(std::exp(log_n(gen)));
+    }
+
+    double seq_time = median_time([&values] {
+        for (int n : values) sequential_factorial(n);
+        }, 3);
+    double par_time = median_time([&values, num_threads] {
+        for (int n : values) parallel_factorial(n, num_threads);
+        }, 3);
+
+    std::cout << values.size() << " вызовов со смешанными n: последовательно " << seq_time
+        << " с, параллельно " << par_time << " с\n";
+}
+
+/*
+ * Проверка factorial_mod по теореме Вильсона: (p - 1)! = -1 (mod p) для простого p
+ */
+void benchmark_factorial_mod(int num_threads) {
+    const uint64_t p = 1000000007;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    uint64_t result = factorial_mod(p - 1, p, num_threads);
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> duration = end - start;
+
+    std::cout << "(p - 1)! mod p при p = " << p << ": " << result
+        << (result == p - 1 ? " (верно)" : " (ОШИБКА)")
+        << ", время " << duration.count() << " с\n";
+}
+
 int main() {
     SetConsoleOutputCP(CP_UTF8);
     setlocale(LC_ALL, "Russian");
     const int n = 20; // Число для вычисления факториала
-    const int num_threads = std::thread::hardware_concurrency(); // Количество потоков
+    const int num_threads = std::max(1u, std::thread::hardware_concurrency()); // Количество потоков
+
+    // Порог, ниже которого параллельная версия считает в текущем потоке
+    std::cout << "Порог параллельного вычисления: n >= " << calibrate_parallel_cutoff(num_threads) << "\n\n";
 
     // Последовательное вычисление
     auto start_seq = std::chrono::high_resolution_clock::now();
-    unsigned long long seq_result = sequential_factorial(n);
+    BigInt seq_result = sequential_factorial(n);
     auto end_seq = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double> seq_duration = end_seq - start_seq;
 
     // Параллельное вычисление
     auto start_par = std::chrono::high_resolution_clock::now();
-    unsigned long long par_result = parallel_factorial(n, num_threads);
+    BigInt par_result = parallel_factorial(n, num_threads);
     auto end_par = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double> par_duration = end_par - start_par;
 
     // Вывод результатов
     std::cout << "Факториал числа " << n << ":\n";
-    std::cout << "Последовательный результат: " << seq_result << "\n";
-    std::cout << "Параллельный результат:    " << par_result << "\n\n";
+    std::cout << "Последовательный результат: " << describe(seq_result) << "\n";
+    std::cout << "Параллельный результат:    " << describe(par_result) << "\n\n";
 
     std::cout << "Сравнение времени выполнения:\n";
     std::cout << "Последовательный: " << seq_duration.count() << " секунд\n";
@@ -95,7 +907,11 @@ int main() {
 
     // Вычисление ускорения
     double speedup = seq_duration.count() / par_duration.count();
-    std::cout << "Ускорение: " << speedup << "x\n";
+    std::cout << "Ускорение: " << speedup << "x\n\n";
+
+    benchmark_factorial(num_threads);
+    benchmark_mixed_calls(num_threads);
+    benchmark_factorial_mod(num_threads);
 
     return 0;
 }
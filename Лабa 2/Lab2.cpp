@@ -6,19 +6,59 @@
 #include <locale>
 #include <windows.h>
 #include <cstdlib> // для srand
+#include <algorithm>
+#include <string>
+#include <cstdint>
+#include "../common/matrix.h"
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 using namespace std;
 using namespace std::chrono;
 
+// Максимальный размер матрицы для эталонного разложения Лапласа (O(n!))
+const int MAX_COFACTOR_SIZE = 10;
+
+// Максимальный размер для разложения Лапласа с запоминанием миноров (таблица 2^n значений)
+const int MAX_MASKED_COFACTOR_SIZE = 22;
+
+// Максимальный размер для точного определителя в main: около n / 31 простых модулей,
+// по исключению O(n^3) на каждый, поэтому время растет как n^4
+const int MAX_EXACT_SIZE = 500;
+
+// Ширина панели LU-разложения (столбцов) и ширина плитки обновления (столбцов)
+const int LU_PANEL_SIZE = 64;
+const int LU_TILE_COLS = 256;
+
+// Количество матриц, обрабатываемых пакетным ядром за раз (по одной на SIMD-полосу)
+const int BATCH_LANES = 8;
+
+// Промежуточное произведение Bareiss считается в 128 битах: __int128 в GCC/Clang, _mul128/_div128 в MSVC x64
+#if defined(__SIZEOF_INT128__) || (defined(_MSC_VER) && defined(_M_X64))
+#define BAREISS_INT128 1
+#endif
+
+// Граница log2 оценки Адамара, до которой Bareiss считает без переполнения:
+// все миноры меньше 2^62, произведения двух миноров помещаются в 128 бит
+#ifdef BAREISS_INT128
+const double BAREISS_INT64_BITS = 62.0;
+#else
+const double BAREISS_INT64_BITS = 30.0;
+#endif
+
+// Строки шага Bareiss обновляются параллельно, только если их больше этого числа
+const int BAREISS_PARALLEL_ROWS = 64;
+
 /*
  * Создает подматрицу, исключая указанные строку и столбец
  * matrix - исходная матрица
  * excludeRow - исключаемая строка
  * excludeCol - исключаемый столбец
  */
-vector<vector<double>> getSubmatrix(const vector<vector<double>>& matrix, int excludeRow, int excludeCol) {
-    int n = matrix.size() - 1;
-    vector<vector<double>> submatrix(n, vector<double>(n));
+Matrix<double> getSubmatrix(const Matrix<double>& matrix, int excludeRow, int excludeCol) {
+    int n = matrix.rows() - 1;
+    Matrix<double> submatrix(n, n);
 
     for (int i = 0, row = 0; row < n; i++, row++) {
         if (i == excludeRow) i++;
@@ -33,8 +73,8 @@ vector<vector<double>> getSubmatrix(const vector<vector<double>>& matrix, int ex
 /*
  * Последовательное вычисление определителя (рекурсивный метод)
  */
-double determinantSequential(const vector<vector<double>>& matrix) {
-    int n = matrix.size();
+double determinantSequential(const Matrix<double>& matrix) {
+    int n = matrix.rows();
     if (n == 1) return matrix[0][0];
     if (n == 2) return matrix[0][0] * matrix[1][1] - matrix[0][1] * matrix[1][0];
 
@@ -46,33 +86,716 @@ double determinantSequential(const vector<vector<double>>& matrix) {
     return det;
 }
 
+// Число единичных бит
+int bitCount(uint32_t x) {
+    int count = 0;
+    for (; x != 0; x &= x - 1) count++;
+    return count;
+}
+
 /*
- * Параллельное вычисление определителя с использованием OpenMP
+ * Параллельное вычисление определителя разложением Лапласа без копирования подматриц
+ * (размер не больше MAX_MASKED_COFACTOR_SIZE)
+ *
+ * При разложении по первой оставшейся строке минор задается только набором
+ * столбцов (битовой маской): его строки - последние popcount(mask) строк матрицы.
+ * Одинаковые миноры встречаются многократно, поэтому каждый считается один раз
+ * и запоминается в таблице minors[mask]. Маски обрабатываются слоями по числу
+ * столбцов, каждый слой делится между потоками OpenMP.
+ * Порядок операций для каждого минора тот же, что в determinantSequential,
+ * поэтому результаты совпадают бит в бит.
  */
-double determinantParallel(const vector<vector<double>>& matrix) {
-    int n = matrix.size();
+double determinantParallel(const Matrix<double>& matrix) {
+    int n = matrix.rows();
     if (n == 1) return matrix[0][0];
     if (n == 2) return matrix[0][0] * matrix[1][1] - matrix[0][1] * matrix[1][0];
 
-    double det = 0;
-#pragma omp parallel for reduction(+:det)
-    for (int col = 0; col < n; col++) {
-        auto submatrix = getSubmatrix(matrix, 0, col);
-        det += matrix[0][col] * ((col % 2 == 0) ? 1 : -1) * determinantSequential(submatrix);
+    // Маски, упорядоченные по числу единиц: слой k - order[layerStart[k] .. layerStart[k + 1])
+    const uint32_t full = (1u << n) - 1;
+    vector<size_t> layerStart(n + 2, 0);
+    for (uint32_t mask = 0; mask <= full; mask++) {
+        layerStart[bitCount(mask) + 1]++;
+    }
+    for (int k = 1; k <= n + 1; k++) {
+        layerStart[k] += layerStart[k - 1];
+    }
+    vector<uint32_t> order(static_cast<size_t>(full) + 1);
+    vector<size_t> position(layerStart.begin(), layerStart.end() - 1);
+    for (uint32_t mask = 0; mask <= full; mask++) {
+        order[position[bitCount(mask)]++] = mask;
+    }
+
+    vector<double> minors(static_cast<size_t>(full) + 1);
+    const double* last = matrix[n - 1];
+    const double* beforeLast = matrix[n - 2];
+
+    for (int k = 1; k <= n; k++) {
+        const double* top = matrix[n - k]; // Первая строка минора
+        const long long layerBegin = layerStart[k];
+        const long long layerEnd = layerStart[k + 1];
+
+#pragma omp parallel for schedule(static)
+        for (long long idx = layerBegin; idx < layerEnd; idx++) {
+            const uint32_t mask = order[idx];
+            if (k == 1) {
+                int c = 0;
+                while (!(mask >> c & 1)) c++;
+                minors[mask] = last[c];
+                continue;
+            }
+            if (k == 2) {
+                int c0 = 0;
+                while (!(mask >> c0 & 1)) c0++;
+                int c1 = c0 + 1;
+                while (!(mask >> c1 & 1)) c1++;
+                minors[mask] = beforeLast[c0] * last[c1] - beforeLast[c1] * last[c0];
+                continue;
+            }
+
+            double det = 0;
+            int position = 0;
+            for (uint32_t rest = mask; rest != 0; rest &= rest - 1, position++) {
+                const uint32_t bit = rest & (0u - rest);
+                int col = 0;
+                while ((1u << col) != bit) col++;
+                det += top[col] * ((position % 2 == 0) ? 1 : -1) * minors[mask ^ bit];
+            }
+            minors[mask] = det;
+        }
+    }
+    return minors[full];
+}
+
+/*
+ * Определитель в виде знака и натурального логарифма модуля:
+ * для больших матриц сам определитель выходит за пределы double
+ */
+struct LogDeterminant {
+    double logAbs; // ln|det|, -inf для вырожденной матрицы
+    int sign;      // -1, 0 или 1
+
+    double value() const { return sign == 0 ? 0.0 : sign * exp(logAbs); }
+};
+
+/*
+ * Определитель через блочное LU-разложение с частичным выбором ведущего элемента, O(n^3)
+ * matrix - исходная матрица (не изменяется, разложение строится в копии)
+ *
+ * Столбцы обрабатываются панелями по LU_PANEL_SIZE:
+ * 1. панель раскладывается по столбцам с перестановкой строк;
+ * 2. строки панели справа от нее решаются треугольной системой (U12 = L11^-1 * A12);
+ * 3. оставшаяся матрица обновляется A22 -= L21 * U12 плитками, плитки
+ *    распределяются между потоками OpenMP, строка U12 плитки остается в кэше.
+ */
+LogDeterminant logDeterminantLU(const Matrix<double>& matrix) {
+    const int n = matrix.rows();
+    LogDeterminant det{ 0.0, 1 };
+    if (n == 0) return det;
+
+    Matrix<double> a = matrix.clone();
+    auto row = [&a](int i) { return a[i]; };
+
+    for (int k0 = 0; k0 < n; k0 += LU_PANEL_SIZE) {
+        const int kEnd = min(k0 + LU_PANEL_SIZE, n);
+
+        // 1. Разложение панели [k0, kEnd)
+        for (int k = k0; k < kEnd; k++) {
+            int pivot = k;
+            for (int i = k + 1; i < n; i++) {
+                if (fabs(row(i)[k]) > fabs(row(pivot)[k])) pivot = i;
+            }
+            double pivotValue = row(pivot)[k];
+            if (pivotValue == 0.0) {
+                return LogDeterminant{ -HUGE_VAL, 0 };
+            }
+            if (pivot != k) {
+                swap_ranges(row(k), row(k) + n, row(pivot));
+                det.sign = -det.sign;
+            }
+            det.logAbs += log(fabs(pivotValue));
+            if (pivotValue < 0) det.sign = -det.sign;
+
+            const double* pivotRow = row(k);
+#pragma omp parallel for schedule(static)
+            for (int i = k + 1; i < n; i++) {
+                double* r = row(i);
+                double l = r[k] / pivotValue;
+                r[k] = l;
+                for (int j = k + 1; j < kEnd; j++) {
+                    r[j] -= l * pivotRow[j];
+                }
+            }
+        }
+        if (kEnd == n) break;
+
+        // 2. U12 = L11^-1 * A12 (прямая подстановка, столбцы независимы)
+        const int tiles = (n - kEnd + LU_TILE_COLS - 1) / LU_TILE_COLS;
+#pragma omp parallel for schedule(static)
+        for (int t = 0; t < tiles; t++) {
+            const int jBegin = kEnd + t * LU_TILE_COLS;
+            const int jEnd = min(jBegin + LU_TILE_COLS, n);
+            for (int k = k0; k < kEnd; k++) {
+                const double* u = row(k);
+                for (int i = k + 1; i < kEnd; i++) {
+                    double* r = row(i);
+                    const double l = r[k];
+#pragma omp simd
+                    for (int j = jBegin; j < jEnd; j++) {
+                        r[j] -= l * u[j];
+                    }
+                }
+            }
+        }
+
+        // 3. A22 -= L21 * U12 по плиткам (блок строк x блок столбцов)
+        const int rowBlocks = (n - kEnd + LU_PANEL_SIZE - 1) / LU_PANEL_SIZE;
+#pragma omp parallel for collapse(2) schedule(static)
+        for (int rb = 0; rb < rowBlocks; rb++) {
+            for (int t = 0; t < tiles; t++) {
+                const int iBegin = kEnd + rb * LU_PANEL_SIZE;
+                const int iEnd = min(iBegin + LU_PANEL_SIZE, n);
+                const int jBegin = kEnd + t * LU_TILE_COLS;
+                const int jEnd = min(jBegin + LU_TILE_COLS, n);
+                for (int i = iBegin; i < iEnd; i++) {
+                    double* r = row(i);
+                    for (int k = k0; k < kEnd; k++) {
+                        const double l = r[k];
+                        const double* u = row(k);
+#pragma omp simd
+                        for (int j = jBegin; j < jEnd; j++) {
+                            r[j] -= l * u[j];
+                        }
+                    }
+                }
+            }
+        }
     }
     return det;
 }
 
+/*
+ * Определитель через блочное LU-разложение (может переполниться для больших n,
+ * тогда используйте logDeterminantLU)
+ */
+double determinantLU(const Matrix<double>& matrix) {
+    return logDeterminantLU(matrix).value();
+}
+
+/*
+ * Длинное целое со знаком для точного определителя.
+ * Модуль хранится массивом 32-битных слов, младшие слова первыми.
+ */
+struct BigInteger {
+    vector<uint32_t> limbs;
+    int sign = 0; // -1, 0 или 1
+
+    BigInteger(long long value = 0) {
+        sign = (value > 0) - (value < 0);
+        unsigned long long magnitude = value < 0 ? 0ull - static_cast<unsigned long long>(value) : value;
+        for (; magnitude != 0; magnitude >>= 32) {
+            limbs.push_back(static_cast<uint32_t>(magnitude));
+        }
+    }
+
+    // |x| = |x| * m + add
+    void mulAddSmall(uint32_t m, uint32_t add) {
+        uint64_t carry = add;
+        for (auto& limb : limbs) {
+            uint64_t t = static_cast<uint64_t>(limb) * m + carry;
+            limb = static_cast<uint32_t>(t);
+            carry = t >> 32;
+        }
+        if (carry != 0) limbs.push_back(static_cast<uint32_t>(carry));
+        while (!limbs.empty() && limbs.back() == 0) limbs.pop_back();
+        if (sign == 0 && !limbs.empty()) sign = 1;
+        if (limbs.empty()) sign = 0;
+    }
+
+    // Сравнение модулей: -1, 0, 1
+    static int compareAbs(const BigInteger& a, const BigInteger& b) {
+        if (a.limbs.size() != b.limbs.size()) return a.limbs.size() < b.limbs.size() ? -1 : 1;
+        for (size_t i = a.limbs.size(); i-- > 0;) {
+            if (a.limbs[i] != b.limbs[i]) return a.limbs[i] < b.limbs[i] ? -1 : 1;
+        }
+        return 0;
+    }
+
+    // |a| - |b| при |a| >= |b|
+    static BigInteger subtractAbs(const BigInteger& a, const BigInteger& b) {
+        BigInteger result;
+        result.limbs = a.limbs;
+        int64_t borrow = 0;
+        for (size_t i = 0; i < result.limbs.size(); i++) {
+            int64_t t = static_cast<int64_t>(result.limbs[i]) - (i < b.limbs.size() ? b.limbs[i] : 0) - borrow;
+            borrow = t < 0;
+            result.limbs[i] = static_cast<uint32_t>(t);
+        }
+        while (!result.limbs.empty() && result.limbs.back() == 0) result.limbs.pop_back();
+        result.sign = result.limbs.empty() ? 0 : 1;
+        return result;
+    }
+
+    string toString() const {
+        if (sign == 0) return "0";
+        vector<uint32_t> rest = limbs;
+        vector<uint32_t> chunks; // Группы по 9 десятичных цифр, младшие первыми
+        while (!rest.empty()) {
+            uint64_t remainder = 0;
+            for (size_t i = rest.size(); i-- > 0;) {
+                uint64_t cur = (remainder << 32) | rest[i];
+                rest[i] = static_cast<uint32_t>(cur / 1000000000u);
+                remainder = cur % 1000000000u;
+            }
+            chunks.push_back(static_cast<uint32_t>(remainder));
+            while (!rest.empty() && rest.back() == 0) rest.pop_back();
+        }
+        string result = sign < 0 ? "-" : "";
+        result += to_string(chunks.back());
+        for (size_t i = chunks.size() - 1; i-- > 0;) {
+            string part = to_string(chunks[i]);
+            result += string(9 - part.size(), '0') + part;
+        }
+        return result;
+    }
+};
+
+/*
+ * Перевод матрицы с целыми элементами из double в long long
+ */
+Matrix<long long> toIntegerMatrix(const Matrix<double>& matrix) {
+    Matrix<long long> result(matrix.rows(), matrix.cols());
+    for (size_t i = 0; i < matrix.rows(); i++) {
+        for (size_t j = 0; j < matrix.cols(); j++) {
+            result[i][j] = llround(matrix[i][j]);
+        }
+    }
+    return result;
+}
+
+/*
+ * log2 оценки Адамара: |det| <= П ||строка i||
+ * Все миноры, возникающие в методе Bareiss, ограничены той же оценкой.
+ */
+double hadamardBoundLog2(const Matrix<long long>& matrix) {
+    double bits = 0;
+    for (size_t i = 0; i < matrix.rows(); i++) {
+        double norm2 = 0;
+        for (size_t j = 0; j < matrix.cols(); j++) {
+            norm2 += static_cast<double>(matrix[i][j]) * matrix[i][j];
+        }
+        if (norm2 == 0) return -HUGE_VAL; // Нулевая строка: det = 0
+        bits += 0.5 * log2(norm2);
+    }
+    return bits;
+}
+
+/*
+ * (a * b - c * d) / divisor для Bareiss: деление точное, частное помещается в long long,
+ * а произведения до 2^124 считаются в 128 битах
+ */
+inline long long bareissStep(long long a, long long b, long long c, long long d, long long divisor) {
+#if defined(__SIZEOF_INT128__)
+    __int128 value = static_cast<__int128>(a) * b - static_cast<__int128>(c) * d;
+    return static_cast<long long>(value / divisor);
+#elif defined(BAREISS_INT128)
+    long long high1, high2, remainder;
+    unsigned long long low1 = static_cast<unsigned long long>(_mul128(a, b, &high1));
+    unsigned long long low2 = static_cast<unsigned long long>(_mul128(c, d, &high2));
+    unsigned long long low = low1 - low2;
+    long long high = high1 - high2 - (low1 < low2 ? 1 : 0);
+    return _div128(high, static_cast<long long>(low), divisor, &remainder);
+#else
+    return (a * b - c * d) / divisor;
+#endif
+}
+
+/*
+ * Метод Bareiss (исключение без дробей) в long long.
+ * Каждый промежуточный элемент - минор исходной матрицы, деление на предыдущий
+ * ведущий элемент всегда точное. Точен, пока оценка Адамара < 2^BAREISS_INT64_BITS.
+ * Строки шага обновляются параллельно, если их больше BAREISS_PARALLEL_ROWS.
+ */
+long long determinantBareiss(Matrix<long long> m) {
+    const int n = m.rows();
+    if (n == 0) return 1;
+    int sign = 1;
+    long long previous = 1;
+
+    for (int k = 0; k < n - 1; k++) {
+        if (m[k][k] == 0) {
+            int pivot = k + 1;
+            while (pivot < n && m[pivot][k] == 0) pivot++;
+            if (pivot == n) return 0;
+            swap_ranges(m[k], m[k] + n, m[pivot]);
+            sign = -sign;
+        }
+
+        const long long pivotValue = m[k][k];
+        const long long* pivotRow = m[k];
+#pragma omp parallel for schedule(static) if(n - k - 1 > BAREISS_PARALLEL_ROWS)
+        for (int i = k + 1; i < n; i++) {
+            long long* r = m[i];
+            const long long factor = r[k];
+            for (int j = k + 1; j < n; j++) {
+                r[j] = bareissStep(r[j], pivotValue, factor, pivotRow[j], previous);
+            }
+        }
+        previous = pivotValue;
+    }
+    return sign * m[n - 1][n - 1];
+}
+
+// a^e mod p
+uint32_t powMod(uint32_t a, uint32_t e, uint32_t p) {
+    uint64_t result = 1, base = a % p;
+    for (; e != 0; e >>= 1) {
+        if (e & 1) result = result * base % p;
+        base = base * base % p;
+    }
+    return static_cast<uint32_t>(result);
+}
+
+// Детерминированный тест Миллера-Рабина для 32-битных чисел (основания 2, 7, 61)
+bool isPrime32(uint32_t n) {
+    if (n < 2) return false;
+    for (uint32_t p : { 2u, 3u, 5u, 7u, 11u, 13u, 61u }) {
+        if (n % p == 0) return n == p;
+    }
+    uint32_t d = n - 1;
+    int r = 0;
+    while (d % 2 == 0) {
+        d /= 2;
+        r++;
+    }
+    for (uint32_t a : { 2u, 7u, 61u }) {
+        uint64_t x = powMod(a, d, n);
+        if (x == 1 || x == n - 1) continue;
+        bool composite = true;
+        for (int i = 1; i < r && composite; i++) {
+            x = x * x % n;
+            if (x == n - 1) composite = false;
+        }
+        if (composite) return false;
+    }
+    return true;
+}
+
+// count наибольших простых, меньших 2^31
+vector<uint32_t> largePrimes(int count) {
+    vector<uint32_t> primes;
+    for (uint32_t candidate = (1u << 31) - 1; static_cast<int>(primes.size()) < count; candidate -= 2) {
+        if (isPrime32(candidate)) primes.push_back(candidate);
+    }
+    return primes;
+}
+
+/*
+ * Определитель по модулю простого p < 2^31 методом Гаусса.
+ * Умножение на множитель строки - по Шоупу (множитель фиксирован для строки):
+ * без деления, только 32/64-битные умножения, поэтому внутренний цикл векторизуется.
+ */
+uint32_t determinantModPrime(const Matrix<long long>& matrix, uint32_t p) {
+    const int n = matrix.rows();
+    Matrix<uint32_t> a(n, n);
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            long long value = matrix[i][j] % static_cast<long long>(p);
+            a[i][j] = static_cast<uint32_t>(value < 0 ? value + p : value);
+        }
+    }
+    auto row = [&a](int i) { return a[i]; };
+
+    uint64_t det = 1;
+    for (int k = 0; k < n; k++) {
+        int pivot = k;
+        while (pivot < n && row(pivot)[k] == 0) pivot++;
+        if (pivot == n) return 0;
+        if (pivot != k) {
+            swap_ranges(row(k), row(k) + n, row(pivot));
+            det = p - det;
+        }
+        const uint32_t pivotValue = row(k)[k];
+        det = det * pivotValue % p;
+        const uint32_t inverse = powMod(pivotValue, p - 2, p);
+        const uint32_t* u = row(k);
+
+        for (int i = k + 1; i < n; i++) {
+            uint32_t* r = row(i);
+            if (r[k] == 0) continue;
+            const uint32_t factor = static_cast<uint32_t>(static_cast<uint64_t>(r[k]) * inverse % p);
+            const uint32_t factorShoup = static_cast<uint32_t>((static_cast<uint64_t>(factor) << 32) / p);
+            for (int j = k + 1; j < n; j++) {
+                uint32_t q = static_cast<uint32_t>((static_cast<uint64_t>(factorShoup) * u[j]) >> 32);
+                uint32_t t = factor * u[j] - q * p; // factor * u[j] mod p, в [0, 2p)
+                t = t >= p ? t - p : t;
+                r[j] = r[j] >= t ? r[j] - t : r[j] + p - t;
+            }
+        }
+    }
+    return static_cast<uint32_t>(det);
+}
+
+/*
+ * Восстановление целого по остаткам (китайская теорема об остатках, схема Гарнера).
+ * Результат лежит в симметричном диапазоне (-M/2, M/2], M = П primes.
+ */
+BigInteger reconstructCRT(const vector<uint32_t>& residues, const vector<uint32_t>& primes) {
+    const size_t k = primes.size();
+
+    // Смешанная система счисления: x = c0 + c1*p0 + c2*p0*p1 + ...
+    vector<uint32_t> coeffs(k);
+    for (size_t i = 0; i < k; i++) {
+        const uint64_t p = primes[i];
+        uint64_t value = 0;    // c0 + c1*p0 + ... по модулю p
+        uint64_t radix = 1;    // p0 * ... * p(i-1) по модулю p
+        for (size_t j = 0; j < i; j++) {
+            value = (value + coeffs[j] * radix) % p;
+            radix = radix * (primes[j] % p) % p;
+        }
+        uint64_t diff = (residues[i] + p - value) % p;
+        coeffs[i] = static_cast<uint32_t>(diff * powMod(static_cast<uint32_t>(radix), static_cast<uint32_t>(p - 2), static_cast<uint32_t>(p)) % p);
+    }
+
+    BigInteger x, modulus(1);
+    for (size_t i = k; i-- > 0;) {
+        x.mulAddSmall(primes[i], coeffs[i]);
+    }
+    for (uint32_t p : primes) {
+        modulus.mulAddSmall(p, 0);
+    }
+
+    // x > M/2  =>  x - M < 0
+    BigInteger twice = x;
+    twice.mulAddSmall(2, 0);
+    if (BigInteger::compareAbs(twice, modulus) > 0) {
+        BigInteger negative = BigInteger::subtractAbs(modulus, x);
+        negative.sign = -1;
+        return negative;
+    }
+    return x;
+}
+
+/*
+ * Точный определитель целочисленной матрицы.
+ * Если оценка Адамара меньше 2^BAREISS_INT64_BITS - метод Bareiss в long long
+ * со 128-битными промежуточными произведениями; иначе - мультимодульная схема: определитель по модулю
+ * нескольких простых < 2^31 (каждое простое в своем потоке) и восстановление по КТО.
+ */
+BigInteger determinantExact(const Matrix<double>& matrix) {
+    auto integerMatrix = toIntegerMatrix(matrix);
+    if (integerMatrix.empty()) return BigInteger(1);
+
+    double boundBits = hadamardBoundLog2(integerMatrix);
+    if (boundBits == -HUGE_VAL) return BigInteger(0);
+    if (boundBits < BAREISS_INT64_BITS) return BigInteger(determinantBareiss(move(integerMatrix)));
+
+    // Нужно M > 2 * H; каждое простое дает не меньше 30.99 бит
+    int primeCount = static_cast<int>(ceil((boundBits + 2) / 30.99));
+    vector<uint32_t> primes = largePrimes(primeCount);
+    vector<uint32_t> residues(primes.size());
+
+#pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < primeCount; i++) {
+        residues[i] = determinantModPrime(integerMatrix, primes[i]);
+    }
+    return reconstructCRT(residues, primes);
+}
+
+/*
+ * Пачка маленьких матриц n x n (n <= 8) в раскладке "структура массивов":
+ * элемент (i, j) всех матриц лежит подряд - data[(i * n + j) * count + m].
+ * Тогда соседние матрицы попадают в соседние SIMD-полосы.
+ */
+struct MatrixBatch {
+    int n;
+    size_t count;
+    vector<double> data;
+
+    MatrixBatch(int n, size_t count) : n(n), count(count), data(static_cast<size_t>(n) * n * count) {}
+
+    double& at(size_t m, int i, int j) { return data[(static_cast<size_t>(i) * n + j) * count + m]; }
+    double at(size_t m, int i, int j) const { return data[(static_cast<size_t>(i) * n + j) * count + m]; }
+
+    // Матрица с номером m в обычном виде
+    Matrix<double> extract(size_t m) const {
+        Matrix<double> matrix(n, n);
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < n; j++) {
+                matrix[i][j] = at(m, i, j);
+            }
+        }
+        return matrix;
+    }
+};
+
+/*
+ * Определители lanes (<= BATCH_LANES) матриц размера N, начиная с матрицы first.
+ * N = 1..3 - явные формулы, N >= 4 - метод Гаусса, развернутый компилятором
+ * для конкретного N. Выбор ведущего элемента сделан без ветвлений: строка k
+ * меняется со строкой i в тех полосах, где |a[i][k]| больше, поэтому все
+ * полосы выполняют одинаковые инструкции.
+ */
+template <int N>
+void determinantTile(const double* data, size_t count, size_t first, int lanes, double* out) {
+    auto element = [data, count, first](int i, int j) { return data + (static_cast<size_t>(i) * N + j) * count + first; };
+
+    if (N == 1) {
+        const double* a00 = element(0, 0);
+#pragma omp simd
+        for (int l = 0; l < lanes; l++) out[first + l] = a00[l];
+        return;
+    }
+    if (N == 2) {
+        const double *a00 = element(0, 0), *a01 = element(0, 1), *a10 = element(1, 0), *a11 = element(1, 1);
+#pragma omp simd
+        for (int l = 0; l < lanes; l++) out[first + l] = a00[l] * a11[l] - a01[l] * a10[l];
+        return;
+    }
+    if (N == 3) {
+        const double *a00 = element(0, 0), *a01 = element(0, 1), *a02 = element(0, 2);
+        const double *a10 = element(1, 0), *a11 = element(1, 1), *a12 = element(1, 2);
+        const double *a20 = element(2, 0), *a21 = element(2, 1), *a22 = element(2, 2);
+#pragma omp simd
+        for (int l = 0; l < lanes; l++) {
+            out[first + l] = a00[l] * (a11[l] * a22[l] - a12[l] * a21[l])
+                - a01[l] * (a10[l] * a22[l] - a12[l] * a20[l])
+                + a02[l] * (a10[l] * a21[l] - a11[l] * a20[l]);
+        }
+        return;
+    }
+
+    // Неполная группа дополняется нулевыми матрицами, чтобы циклы по полосам
+    // имели постоянную длину BATCH_LANES
+    double a[N][N][BATCH_LANES];
+    double det[BATCH_LANES];
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) {
+            const double* source = element(i, j);
+            for (int l = 0; l < BATCH_LANES; l++) a[i][j][l] = l < lanes ? source[l] : 0.0;
+        }
+    }
+    for (int l = 0; l < BATCH_LANES; l++) det[l] = 1;
+
+    for (int k = 0; k < N; k++) {
+        for (int i = k + 1; i < N; i++) {
+            bool larger[BATCH_LANES];
+#pragma omp simd
+            for (int l = 0; l < BATCH_LANES; l++) {
+                larger[l] = fabs(a[i][k][l]) > fabs(a[k][k][l]);
+                det[l] = larger[l] ? -det[l] : det[l];
+            }
+            for (int j = k; j < N; j++) {
+#pragma omp simd
+                for (int l = 0; l < BATCH_LANES; l++) {
+                    const double x = a[k][j][l], y = a[i][j][l];
+                    a[k][j][l] = larger[l] ? y : x;
+                    a[i][j][l] = larger[l] ? x : y;
+                }
+            }
+        }
+
+        double inverse[BATCH_LANES];
+#pragma omp simd
+        for (int l = 0; l < BATCH_LANES; l++) {
+            const double pivot = a[k][k][l];
+            inverse[l] = pivot != 0 ? 1.0 / pivot : 0.0;
+            det[l] *= pivot;
+        }
+        for (int i = k + 1; i < N; i++) {
+            double factor[BATCH_LANES];
+#pragma omp simd
+            for (int l = 0; l < BATCH_LANES; l++) factor[l] = a[i][k][l] * inverse[l];
+            for (int j = k + 1; j < N; j++) {
+#pragma omp simd
+                for (int l = 0; l < BATCH_LANES; l++) a[i][j][l] -= factor[l] * a[k][j][l];
+            }
+        }
+    }
+
+    for (int l = 0; l < lanes; l++) out[first + l] = det[l];
+}
+
+// Определители всей пачки размера N: группы по BATCH_LANES матриц делятся между потоками
+template <int N>
+void determinantBatchFixed(const MatrixBatch& batch, double* out) {
+    const long long tiles = (batch.count + BATCH_LANES - 1) / BATCH_LANES;
+#pragma omp parallel for schedule(static)
+    for (long long t = 0; t < tiles; t++) {
+        size_t first = static_cast<size_t>(t) * BATCH_LANES;
+        int lanes = static_cast<int>(min<size_t>(BATCH_LANES, batch.count - first));
+        determinantTile<N>(batch.data.data(), batch.count, first, lanes, out);
+    }
+}
+
+/*
+ * Пакетное вычисление определителей: out[m] = det(матрица m)
+ * Для n > 8 каждая матрица считается LU-разложением.
+ */
+void determinantBatch(const MatrixBatch& batch, vector<double>& out) {
+    out.resize(batch.count);
+    switch (batch.n) {
+    case 1: determinantBatchFixed<1>(batch, out.data()); break;
+    case 2: determinantBatchFixed<2>(batch, out.data()); break;
+    case 3: determinantBatchFixed<3>(batch, out.data()); break;
+    case 4: determinantBatchFixed<4>(batch, out.data()); break;
+    case 5: determinantBatchFixed<5>(batch, out.data()); break;
+    case 6: determinantBatchFixed<6>(batch, out.data()); break;
+    case 7: determinantBatchFixed<7>(batch, out.data()); break;
+    case 8: determinantBatchFixed<8>(batch, out.data()); break;
+    default:
+#pragma omp parallel for schedule(dynamic)
+        for (long long m = 0; m < static_cast<long long>(batch.count); m++) {
+            out[m] = determinantLU(batch.extract(m));
+        }
+    }
+}
+
+/*
+ * Сравнение пакетного API с вызовом determinantSequential для каждой матрицы.
+ * Эталон слишком медленный для всей пачки, поэтому он считается на первых
+ * матрицах, а время пересчитывается на одну матрицу.
+ */
+void benchmarkBatch() {
+    const size_t totalElements = 1 << 24;
+    cout << "\nПакетное вычисление определителей маленьких матриц:\n";
+
+    for (int n : { 2, 3, 4, 6, 8 }) {
+        const size_t count = totalElements / (n * n);
+        MatrixBatch batch(n, count);
+        for (auto& value : batch.data) {
+            value = rand() % 10;
+        }
+
+        vector<double> results;
+        auto start = high_resolution_clock::now();
+        determinantBatch(batch, results);
+        double batchNs = duration_cast<nanoseconds>(high_resolution_clock::now() - start).count() / static_cast<double>(count);
+
+        const size_t referenceCount = n <= 6 ? 2000 : 20;
+        double maxError = 0;
+        start = high_resolution_clock::now();
+        for (size_t m = 0; m < referenceCount; m++) {
+            double reference = determinantSequential(batch.extract(m));
+            maxError = max(maxError, fabs(reference - results[m]) / max(1.0, fabs(reference)));
+        }
+        double referenceNs = duration_cast<nanoseconds>(high_resolution_clock::now() - start).count() / static_cast<double>(referenceCount);
+
+        cout << n << "x" << n << ": " << count << " матриц, пакетно " << batchNs << " нс/матрица, "
+            << "по одной " << referenceNs << " нс/матрица, ускорение " << referenceNs / batchNs
+            << "x, отн. погрешность " << maxError << "\n";
+    }
+}
+
 /*
  * Генерация случайной квадратной матрицы заданного размера
  * size - размер матрицы
  */
-vector<vector<double>> generateRandomMatrix(int size) {
-    vector<vector<double>> matrix(size, vector<double>(size));
+Matrix<double> generateRandomMatrix(int size) {
+    Matrix<double> matrix(size, size);
     srand(static_cast<unsigned>(time(nullptr)));
-    for (auto& row : matrix) {
-        for (auto& elem : row) {
-            elem = rand() % 10;
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++) {
+            matrix[i][j] = rand() % 10;
         }
     }
     return matrix;
@@ -92,31 +815,91 @@ int main() {
     // Вывод матрицы (для размеров <= 10)
     if (size <= 10) {
         cout << "\nСгенерированная матрица:\n";
-        for (const auto& row : matrix) {
-            for (double val : row) {
-                cout << val << " ";
+        for (int i = 0; i < size; i++) {
+            for (int j = 0; j < size; j++) {
+                cout << matrix[i][j] << " ";
             }
             cout << "\n";
         }
     }
 
-    // Последовательное вычисление
+    double detSeq = 0, detPar = 0;
+    milliseconds durationSeq{ 0 }, durationPar{ 0 };
+    bool cofactorDone = size <= MAX_COFACTOR_SIZE;
+    bool maskedDone = size <= MAX_MASKED_COFACTOR_SIZE;
+    bool exactDone = size <= MAX_EXACT_SIZE;
+
+    if (cofactorDone) {
+        // Последовательное вычисление (эталонное разложение Лапласа)
+        auto start = high_resolution_clock::now();
+        detSeq = determinantSequential(matrix);
+        durationSeq = duration_cast<milliseconds>(high_resolution_clock::now() - start);
+    }
+    if (maskedDone) {
+        // Параллельное вычисление (миноры по маскам столбцов)
+        auto start = high_resolution_clock::now();
+        detPar = determinantParallel(matrix);
+        durationPar = duration_cast<milliseconds>(high_resolution_clock::now() - start);
+    }
+
+    // Блочное LU-разложение
     auto start = high_resolution_clock::now();
-    double detSeq = determinantSequential(matrix);
-    auto durationSeq = duration_cast<milliseconds>(high_resolution_clock::now() - start);
+    LogDeterminant detLU = logDeterminantLU(matrix);
+    auto durationLU = duration_cast<milliseconds>(high_resolution_clock::now() - start);
 
-    // Параллельное вычисление
-    start = high_resolution_clock::now();
-    double detPar = determinantParallel(matrix);
-    auto durationPar = duration_cast<milliseconds>(high_resolution_clock::now() - start);
+    // Точный целочисленный определитель
+    BigInteger detExact;
+    milliseconds durationExact{ 0 };
+    string detExactText;
+    if (exactDone) {
+        start = high_resolution_clock::now();
+        detExact = determinantExact(matrix);
+        durationExact = duration_cast<milliseconds>(high_resolution_clock::now() - start);
+        detExactText = detExact.toString();
+    }
 
     // Вывод результатов
     cout << "\nРезультаты:\n";
-    cout << "Последовательный определитель: " << detSeq << "\n";
-    cout << "Параллельный определитель: " << detPar << "\n";
-    cout << "Время последовательного вычисления: " << durationSeq.count() << " мс\n";
-    cout << "Время параллельного вычисления: " << durationPar.count() << " мс\n";
-    cout << "Ускорение: " << static_cast<double>(durationSeq.count()) / durationPar.count() << "x\n";
+    if (cofactorDone) {
+        cout << "Последовательный определитель: " << detSeq << "\n";
+    }
+    if (maskedDone) {
+        cout << "Параллельный определитель: " << detPar << "\n";
+    }
+    if (cofactorDone) {
+        cout << "Результаты разложения Лапласа " << (detSeq == detPar ? "совпадают" : "НЕ совпадают") << "\n";
+    }
+    cout << "Определитель (LU): " << detLU.value()
+        << " (знак " << detLU.sign << ", log10|det| = " << detLU.logAbs / log(10.0) << ")\n";
+    if (!exactDone) {
+        cout << "Точный определитель пропущен (размер больше " << MAX_EXACT_SIZE << ")\n";
+    }
+    else if (detExactText.size() <= 60) {
+        cout << "Точный определитель: " << detExactText << "\n";
+    }
+    else {
+        cout << "Точный определитель: " << detExactText.substr(0, 30) << "... ("
+            << detExactText.size() - (detExact.sign < 0) << " цифр)\n";
+    }
+    if (cofactorDone) {
+        cout << "Относительное расхождение LU и разложения Лапласа: "
+            << fabs(detLU.value() - detSeq) / max(1.0, fabs(detSeq)) << "\n";
+        cout << "Время последовательного вычисления: " << durationSeq.count() << " мс\n";
+        cout << "Время параллельного вычисления: " << durationPar.count() << " мс\n";
+        cout << "Ускорение: " << static_cast<double>(durationSeq.count()) / max<long long>(1, durationPar.count()) << "x\n";
+    }
+    else {
+        cout << "Последовательное разложение Лапласа пропущено (размер больше " << MAX_COFACTOR_SIZE << ")\n";
+        if (maskedDone) {
+            cout << "Время параллельного вычисления: " << durationPar.count() << " мс\n";
+        }
+    }
+    cout << "Время LU-разложения: " << durationLU.count() << " мс\n";
+    if (exactDone) {
+        cout << "Время точного вычисления: " << durationExact.count() << " мс\n";
+    }
+
+    benchmarkBatch();
 
     return 0;
 }
@@ -1,49 +1,308 @@
 #include <iostream>
+#include <fstream>
 #include <thread>
 #include <mutex>
+#include <condition_variable>
 #include <atomic>
 #include <vector>
+#include <string>
+#include <algorithm>
 #include <chrono>
 #include <windows.h>
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
 
 const int ITERATIONS = 1'000'000;
 const int THREADS_COUNT = 10;
 
+// Параметры бенчмарка конкуренции
+const int SWEEP_ITERATIONS = 20'000; // Операций на поток в одном запуске
+const int SWEEP_REPEATS = 100;       // Запусков на конфигурацию (не меньше 100, чтобы p99 не совпадал с максимумом)
+const int MAX_THREADS = 256;
+
+// Размер строки кэша: счетчики разных потоков не должны делить одну строку
+const size_t CACHE_LINE = 64;
+
+// Параметры бенчмарка очередей
+const int QUEUE_ITEMS = 200'000;    // Элементов на один запуск (делятся между производителями)
+const size_t QUEUE_CAPACITY = 1024;
+const int QUEUE_REPEATS = 5;
+
+// Пауза в цикле ожидания (снижает нагрузку на шину и соседний гиперпоток)
+inline void cpu_relax() {
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#else
+    std::this_thread::yield();
+#endif
+}
+
+// Ожидание с уступкой процессора: при числе потоков больше числа ядер
+// владелец блокировки должен получить время, иначе ожидание длится весь квант
+inline void spin_wait(int& spins) {
+    if (++spins < 64) {
+        cpu_relax();
+    }
+    else {
+        spins = 0;
+        std::this_thread::yield();
+    }
+}
+
+/*
+ * Спин-блокировка test-and-test-and-set: пока блокировка занята, поток только
+ * читает флаг из своего кэша и не генерирует записей в общую строку
+ */
+class TTASSpinlock {
+public:
+    void lock() {
+        int spins = 0;
+        while (true) {
+            if (!locked.exchange(true, std::memory_order_acquire)) return;
+            while (locked.load(std::memory_order_relaxed)) spin_wait(spins);
+        }
+    }
+
+    void unlock() { locked.store(false, std::memory_order_release); }
+
+private:
+    std::atomic<bool> locked{ false };
+};
+
+/*
+ * Билетная блокировка: потоки получают блокировку строго в порядке очереди
+ */
+class TicketLock {
+public:
+    void lock() {
+        unsigned ticket = next_ticket.fetch_add(1, std::memory_order_relaxed);
+        int spins = 0;
+        while (now_serving.load(std::memory_order_acquire) != ticket) spin_wait(spins);
+    }
+
+    void unlock() { now_serving.store(now_serving.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+private:
+    alignas(CACHE_LINE) std::atomic<unsigned> next_ticket{ 0 };
+    alignas(CACHE_LINE) std::atomic<unsigned> now_serving{ 0 };
+};
+
+// Счетчик потока, занимающий целую строку кэша
+struct alignas(CACHE_LINE) PaddedCounter {
+    std::atomic<long long> value{ 0 };
+};
+
+/*
+ * Распределенный счетчик: у каждого потока (ядра) своя ячейка в отдельной
+ * строке кэша, инкремент - relaxed fetch_add в свою ячейку без обмена
+ * строками между ядрами. Точное значение - сумма всех ячеек; приближенное
+ * чтение возвращает сумму, закэшированную не ранее refresh_interval назад
+ */
+class ShardedCounter {
+public:
+    explicit ShardedCounter(size_t shards_count = 0,
+        std::chrono::microseconds refresh_interval = std::chrono::microseconds(1000))
+        : shards(round_up_pow2(shards_count ? shards_count : 2 * std::max(1u, std::thread::hardware_concurrency()))),
+        mask(shards.size() - 1),
+        refresh_ticks(std::chrono::duration_cast<std::chrono::steady_clock::duration>(refresh_interval).count()) {
+    }
+
+    // Инкремент в ячейку текущего потока (ячейка назначается при первом обращении)
+    void add(long long delta = 1) { add(delta, thread_slot()); }
+
+    // Инкремент в ячейку с явным номером (например, номером рабочего потока)
+    void add(long long delta, size_t slot) {
+        shards[slot & mask].value.fetch_add(delta, std::memory_order_relaxed);
+    }
+
+    // Точное чтение: обход всех ячеек (значение на момент окончания всех инкрементов)
+    long long read() const {
+        long long total = 0;
+        for (const auto& shard : shards) {
+            total += shard.value.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    // Приближенное чтение: сумма пересчитывается не чаще раза в refresh_interval,
+    // остальные вызовы читают одну общую переменную
+    long long read_approximate() {
+        long long now = std::chrono::steady_clock::now().time_since_epoch().count();
+        long long last = cached_at.load(std::memory_order_relaxed);
+        if (now - last >= refresh_ticks && cached_at.compare_exchange_strong(last, now, std::memory_order_relaxed)) {
+            cached_total.store(read(), std::memory_order_relaxed);
+        }
+        return cached_total.load(std::memory_order_relaxed);
+    }
+
+    void reset() {
+        for (auto& shard : shards) shard.value.store(0, std::memory_order_relaxed);
+        cached_total.store(0, std::memory_order_relaxed);
+        cached_at.store(0, std::memory_order_relaxed);
+    }
+
+    size_t size() const { return shards.size(); }
+
+private:
+    static size_t round_up_pow2(size_t n) {
+        size_t p = 1;
+        while (p < n) p *= 2;
+        return p;
+    }
+
+    // Номер ячейки потока: выдается по кругу при первом обращении потока
+    static size_t thread_slot() {
+        static std::atomic<size_t> next_slot{ 0 };
+        thread_local size_t slot = next_slot.fetch_add(1, std::memory_order_relaxed);
+        return slot;
+    }
+
+    std::vector<PaddedCounter> shards;
+    size_t mask;
+    long long refresh_ticks;
+    alignas(CACHE_LINE) std::atomic<long long> cached_total{ 0 };
+    std::atomic<long long> cached_at{ 0 };
+};
+
 // Общий ресурс для всех подходов
 int shared_value_no_sync = 0;
 int shared_value_mutex = 0;
 std::atomic<int> shared_value_atomic(0);
+long long shared_value_spinlock = 0;
+long long shared_value_ticket = 0;
+std::atomic<long long> shared_value_relaxed(0);
+std::atomic<long long> shared_value_cas(0);
+PaddedCounter per_thread_counters[MAX_THREADS];
+ShardedCounter shared_value_sharded;
 
 std::mutex mtx;
+TTASSpinlock spinlock;
+TicketLock ticket_lock;
 
-void increment_no_sync() {
-    for (int i = 0; i < ITERATIONS; ++i) {
+void increment_no_sync(int, int iterations) {
+    for (int i = 0; i < iterations; ++i) {
         ++shared_value_no_sync;
     }
 }
 
-void increment_mutex() {
-    for (int i = 0; i < ITERATIONS; ++i) {
+void increment_mutex(int, int iterations) {
+    for (int i = 0; i < iterations; ++i) {
         std::lock_guard<std::mutex> lock(mtx);
         ++shared_value_mutex;
     }
 }
 
-void increment_atomic() {
-    for (int i = 0; i < ITERATIONS; ++i) {
-        ++shared_value_atomic;
+void increment_atomic(int, int iterations) {
+    for (int i = 0; i < iterations; ++i) {
+        ++shared_value_atomic; // fetch_add с memory_order_seq_cst
+    }
+}
+
+void increment_spinlock(int, int iterations) {
+    for (int i = 0; i < iterations; ++i) {
+        std::lock_guard<TTASSpinlock> lock(spinlock);
+        ++shared_value_spinlock;
+    }
+}
+
+void increment_ticket(int, int iterations) {
+    for (int i = 0; i < iterations; ++i) {
+        std::lock_guard<TicketLock> lock(ticket_lock);
+        ++shared_value_ticket;
+    }
+}
+
+void increment_relaxed(int, int iterations) {
+    for (int i = 0; i < iterations; ++i) {
+        shared_value_relaxed.fetch_add(1, std::memory_order_relaxed);
     }
 }
 
-void test_approach(void (*func)(), const std::string& name) {
+void increment_cas(int, int iterations) {
+    for (int i = 0; i < iterations; ++i) {
+        long long expected = shared_value_cas.load(std::memory_order_relaxed);
+        while (!shared_value_cas.compare_exchange_weak(expected, expected + 1, std::memory_order_relaxed)) {
+        }
+    }
+}
+
+// Каждый поток пишет только в свою строку кэша, поэтому хватает load + store
+void increment_per_thread(int thread_index, int iterations) {
+    std::atomic<long long>& counter = per_thread_counters[thread_index].value;
+    for (int i = 0; i < iterations; ++i) {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+}
+
+void increment_sharded(int, int iterations) {
+    for (int i = 0; i < iterations; ++i) {
+        shared_value_sharded.add(1);
+    }
+}
+
+long long sum_per_thread() {
+    long long total = 0;
+    for (const auto& counter : per_thread_counters) {
+        total += counter.value.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+/*
+ * Подход к синхронизации: функция потока, сброс и чтение своего счетчика
+ */
+struct Approach {
+    std::string name;
+    void (*worker)(int thread_index, int iterations);
+    void (*reset)();
+    long long (*value)();
+};
+
+const std::vector<Approach>& all_approaches() {
+    static const std::vector<Approach> approaches = {
+        { "Без синхронизации", increment_no_sync,
+            [] { shared_value_no_sync = 0; }, [] { return static_cast<long long>(shared_value_no_sync); } },
+        { "С мьютексом", increment_mutex,
+            [] { shared_value_mutex = 0; }, [] { return static_cast<long long>(shared_value_mutex); } },
+        { "Атомарные операции (fetch_add seq_cst)", increment_atomic,
+            [] { shared_value_atomic = 0; }, [] { return static_cast<long long>(shared_value_atomic); } },
+        { "Распределенный счетчик", increment_sharded,
+            [] { shared_value_sharded.reset(); }, [] { return shared_value_sharded.read(); } },
+        { "TTAS спин-блокировка", increment_spinlock,
+            [] { shared_value_spinlock = 0; }, [] { return shared_value_spinlock; } },
+        { "Билетная блокировка", increment_ticket,
+            [] { shared_value_ticket = 0; }, [] { return shared_value_ticket; } },
+        { "fetch_add relaxed", increment_relaxed,
+            [] { shared_value_relaxed = 0; }, [] { return shared_value_relaxed.load(); } },
+        { "CAS-цикл", increment_cas,
+            [] { shared_value_cas = 0; }, [] { return shared_value_cas.load(); } },
+        { "Счетчики потоков", increment_per_thread,
+            [] { for (auto& counter : per_thread_counters) counter.value = 0; }, sum_per_thread },
+    };
+    return approaches;
+}
+
+/*
+ * Один запуск подхода: потоки создаются заранее и стартуют одновременно,
+ * время измеряется от старта до завершения последнего потока (сек.)
+ */
+double run_approach(const Approach& approach, int threads_count, int iterations) {
+    approach.reset();
+    std::atomic<bool> go(false);
     std::vector<std::thread> threads;
-    auto start = std::chrono::high_resolution_clock::now();
 
-    // Создаем и запускаем потоки
-    for (int i = 0; i < THREADS_COUNT; ++i) {
-        threads.emplace_back(func);
+    // Создаем потоки, они ждут общего старта
+    for (int i = 0; i < threads_count; ++i) {
+        threads.emplace_back([&approach, &go, i, iterations] {
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            approach.worker(i, iterations);
+            });
     }
 
+    auto start = std::chrono::high_resolution_clock::now();
+    go.store(true, std::memory_order_release);
+
     // Ожидаем завершения всех потоков
     for (auto& t : threads) {
         t.join();
@@ -51,19 +310,318 @@ void test_approach(void (*func)(), const std::string& name) {
 
     auto end = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double> duration = end - start;
+    return duration.count();
+}
+
+void test_approach(const Approach& approach) {
+    double duration = run_approach(approach, THREADS_COUNT, ITERATIONS);
 
     // Выводим результаты
-    if (name == "Без синхронизации") {
-        std::cout << name << ": " << shared_value_no_sync;
+    std::cout << approach.name << ": " << approach.value();
+    std::cout << " | Время выполнения: " << duration << " сек.\n";
+}
+
+// Перцентиль по рангу (sorted должен быть отсортирован)
+double percentile(const std::vector<double>& sorted, double p) {
+    size_t rank = static_cast<size_t>(p * sorted.size() + 0.999999);
+    if (rank < 1) rank = 1;
+    return sorted[std::min(rank, sorted.size()) - 1];
+}
+
+/*
+ * Бенчмарк конкуренции: каждый подход для 1 ... 2 x ядер потоков,
+ * SWEEP_REPEATS запусков на конфигурацию, медиана, p99 и максимум времени,
+ * пропускная способность (операций/сек) и выгрузка в CSV
+ */
+void benchmark_contention(const std::vector<Approach>& approaches, const std::string& csv_path) {
+    int cores = std::max(1u, std::thread::hardware_concurrency());
+    int max_threads = std::min(2 * cores, MAX_THREADS);
+
+    std::vector<int> thread_counts;
+    for (int t = 1; t <= max_threads; t *= 2) thread_counts.push_back(t);
+    thread_counts.push_back(cores);
+    thread_counts.push_back(max_threads);
+    std::sort(thread_counts.begin(), thread_counts.end());
+    thread_counts.erase(std::unique(thread_counts.begin(), thread_counts.end()), thread_counts.end());
+
+    std::ofstream csv(csv_path);
+    csv << "approach,threads,iterations,median_s,p99_s,max_s,ops_per_sec,correct\n";
+
+    std::cout << "\nБенчмарк конкуренции (" << SWEEP_ITERATIONS << " операций на поток, "
+        << SWEEP_REPEATS << " запусков):\n";
+    for (const auto& approach : approaches) {
+        std::cout << approach.name << ":\n";
+        for (int threads_count : thread_counts) {
+            std::vector<double> times;
+            bool correct = true;
+            for (int r = 0; r < SWEEP_REPEATS; ++r) {
+                times.push_back(run_approach(approach, threads_count, SWEEP_ITERATIONS));
+                correct = correct && approach.value() == static_cast<long long>(threads_count) * SWEEP_ITERATIONS;
+            }
+            std::sort(times.begin(), times.end());
+            double median = percentile(times, 0.5);
+            double p99 = percentile(times, 0.99);
+            double worst = times.back();
+            double ops_per_sec = static_cast<double>(threads_count) * SWEEP_ITERATIONS / median;
+
+            std::cout << "  потоков " << threads_count << ": медиана " << median << " сек., p99 " << p99 << " сек., максимум " << worst
+                << " сек., " << ops_per_sec << " оп/сек" << (correct ? "" : " (НЕВЕРНЫЙ РЕЗУЛЬТАТ)") << "\n";
+            csv << '"' << approach.name << "\"," << threads_count << ',' << SWEEP_ITERATIONS << ','
+                << median << ',' << p99 << ',' << worst << ',' << ops_per_sec << ',' << (correct ? 1 : 0) << "\n";
+        }
+    }
+    std::cout << "Результаты сохранены в " << csv_path << "\n";
+}
+
+/*
+ * Ограниченная lock-free очередь для многих производителей и потребителей
+ * (кольцевой буфер с номерами последовательности в ячейках). Ячейка
+ * с sequence == pos свободна для записи позиции pos, с sequence == pos + 1 -
+ * заполнена для чтения. Голова и хвост лежат в разных строках кэша
+ */
+template <typename T>
+class MPMCQueue {
+public:
+    explicit MPMCQueue(size_t capacity) : buffer(round_up_pow2(capacity)), mask(buffer.size() - 1) {
+        for (size_t i = 0; i < buffer.size(); ++i) {
+            buffer[i].sequence.store(i, std::memory_order_relaxed);
+        }
     }
-    else if (name == "С мьютексом") {
-        std::cout << name << ": " << shared_value_mutex;
+
+    bool try_push(const T& item) {
+        size_t pos = tail.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &buffer[pos & mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            long long diff = static_cast<long long>(sequence) - static_cast<long long>(pos);
+            if (diff == 0) {
+                if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            }
+            else if (diff < 0) {
+                return false; // Очередь заполнена
+            }
+            else {
+                pos = tail.load(std::memory_order_relaxed);
+            }
+        }
+        cell->data = item;
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
     }
-    else {
-        std::cout << name << ": " << shared_value_atomic;
+
+    bool try_pop(T& item) {
+        size_t pos = head.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &buffer[pos & mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            long long diff = static_cast<long long>(sequence) - static_cast<long long>(pos + 1);
+            if (diff == 0) {
+                if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            }
+            else if (diff < 0) {
+                return false; // Очередь пуста
+            }
+            else {
+                pos = head.load(std::memory_order_relaxed);
+            }
+        }
+        item = cell->data;
+        cell->sequence.store(pos + mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    void push(const T& item) {
+        int spins = 0;
+        while (!try_push(item)) spin_wait(spins);
+    }
+
+    void pop(T& item) {
+        int spins = 0;
+        while (!try_pop(item)) spin_wait(spins);
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    static size_t round_up_pow2(size_t n) {
+        size_t p = 1;
+        while (p < n) p *= 2;
+        return p;
+    }
+
+    std::vector<Cell> buffer;
+    size_t mask;
+    alignas(CACHE_LINE) std::atomic<size_t> head{ 0 };
+    alignas(CACHE_LINE) std::atomic<size_t> tail{ 0 };
+};
+
+/*
+ * Ограниченная очередь на мьютексе и условных переменных (базовый вариант)
+ */
+template <typename T>
+class MutexQueue {
+public:
+    explicit MutexQueue(size_t capacity) : buffer(capacity) {}
+
+    void push(const T& item) {
+        std::unique_lock<std::mutex> lock(queue_mutex);
+        not_full.wait(lock, [this] { return count < buffer.size(); });
+        buffer[(first + count) % buffer.size()] = item;
+        ++count;
+        lock.unlock();
+        not_empty.notify_one();
     }
 
-    std::cout << " | Время выполнения: " << duration.count() << " сек.\n";
+    void pop(T& item) {
+        std::unique_lock<std::mutex> lock(queue_mutex);
+        not_empty.wait(lock, [this] { return count > 0; });
+        item = buffer[first];
+        first = (first + 1) % buffer.size();
+        --count;
+        lock.unlock();
+        not_full.notify_one();
+    }
+
+private:
+    std::vector<T> buffer;
+    size_t first = 0;
+    size_t count = 0;
+    std::mutex queue_mutex;
+    std::condition_variable not_full;
+    std::condition_variable not_empty;
+};
+
+// Элемент очереди: значение и момент помещения в очередь (тики steady_clock)
+struct QueueItem {
+    long long value;
+    long long stamp;
+};
+
+struct QueueRunResult {
+    double seconds;
+    bool correct;
+};
+
+long long now_ticks() {
+    return std::chrono::steady_clock::now().time_since_epoch().count();
+}
+
+/*
+ * Один запуск очереди: producers потоков кладут по items / producers элементов,
+ * consumers потоков забирают их до получения стоп-элемента (stamp < 0).
+ * Задержка каждого элемента (сек.) дописывается в latencies
+ */
+template <typename Queue>
+QueueRunResult run_queue(int producers, int consumers, int items, std::vector<double>& latencies) {
+    Queue queue(QUEUE_CAPACITY);
+    int per_producer = items / producers;
+    std::atomic<bool> go(false);
+    std::vector<long long> consumed_sums(consumers, 0);
+    std::vector<std::vector<long long>> consumer_latencies(consumers);
+    std::vector<std::thread> threads;
+
+    for (int c = 0; c < consumers; ++c) {
+        consumer_latencies[c].reserve(items / consumers + 1);
+        threads.emplace_back([&, c] {
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            QueueItem item;
+            while (true) {
+                queue.pop(item);
+                if (item.stamp < 0) break;
+                consumer_latencies[c].push_back(now_ticks() - item.stamp);
+                consumed_sums[c] += item.value;
+            }
+            });
+    }
+    std::vector<std::thread> producer_threads;
+    for (int p = 0; p < producers; ++p) {
+        producer_threads.emplace_back([&, p] {
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            for (int i = 0; i < per_producer; ++i) {
+                queue.push(QueueItem{ static_cast<long long>(p) * per_producer + i, now_ticks() });
+            }
+            });
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    go.store(true, std::memory_order_release);
+
+    for (auto& t : producer_threads) t.join();
+    // По одному стоп-элементу на потребителя
+    for (int c = 0; c < consumers; ++c) queue.push(QueueItem{ 0, -1 });
+    for (auto& t : threads) t.join();
+
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> duration = end - start;
+
+    long long total = 0;
+    const double tick = static_cast<double>(std::chrono::steady_clock::period::num) / std::chrono::steady_clock::period::den;
+    for (int c = 0; c < consumers; ++c) {
+        total += consumed_sums[c];
+        for (long long ticks : consumer_latencies[c]) latencies.push_back(ticks * tick);
+    }
+    long long n = static_cast<long long>(per_producer) * producers;
+    return { duration.count(), total == n * (n - 1) / 2 };
+}
+
+/*
+ * Подход к передаче работы: очередь, запускаемая с заданным соотношением
+ * производителей и потребителей
+ */
+struct QueueApproach {
+    std::string name;
+    QueueRunResult (*run)(int producers, int consumers, int items, std::vector<double>& latencies);
+};
+
+/*
+ * Бенчмарк очередей: 1:1, 1:N, N:1 и N:N производителей и потребителей,
+ * медиана пропускной способности (элементов/сек), медиана и p99 задержки
+ * элемента в очереди, выгрузка в CSV
+ */
+void benchmark_queues(const std::string& csv_path) {
+    const std::vector<QueueApproach> queues = {
+        { "Очередь на мьютексе", run_queue<MutexQueue<QueueItem>> },
+        { "Lock-free очередь MPMC", run_queue<MPMCQueue<QueueItem>> },
+    };
+    int cores = std::max(1u, std::thread::hardware_concurrency());
+    int n = std::max(2, cores / 2);
+    const std::vector<std::pair<int, int>> ratios = { { 1, 1 }, { 1, n }, { n, 1 }, { n, n } };
+
+    std::ofstream csv(csv_path);
+    csv << "queue,producers,consumers,items,items_per_sec,latency_median_s,latency_p99_s,correct\n";
+
+    std::cout << "\nБенчмарк очередей (" << QUEUE_ITEMS << " элементов, емкость " << QUEUE_CAPACITY
+        << ", " << QUEUE_REPEATS << " запусков):\n";
+    for (const auto& queue : queues) {
+        std::cout << queue.name << ":\n";
+        for (const auto& ratio : ratios) {
+            std::vector<double> times;
+            std::vector<double> latencies;
+            bool correct = true;
+            for (int r = 0; r < QUEUE_REPEATS; ++r) {
+                QueueRunResult result = queue.run(ratio.first, ratio.second, QUEUE_ITEMS, latencies);
+                times.push_back(result.seconds);
+                correct = correct && result.correct;
+            }
+            std::sort(times.begin(), times.end());
+            std::sort(latencies.begin(), latencies.end());
+            int items = QUEUE_ITEMS / ratio.first * ratio.first;
+            double items_per_sec = items / percentile(times, 0.5);
+            double latency_median = percentile(latencies, 0.5);
+            double latency_p99 = percentile(latencies, 0.99);
+
+            std::cout << "  " << ratio.first << ":" << ratio.second << ": " << items_per_sec << " эл/сек, задержка: медиана "
+                << latency_median << " сек., p99 " << latency_p99 << " сек." << (correct ? "" : " (НЕВЕРНЫЙ РЕЗУЛЬТАТ)") << "\n";
+            csv << '"' << queue.name << "\"," << ratio.first << ',' << ratio.second << ',' << items << ','
+                << items_per_sec << ',' << latency_median << ',' << latency_p99 << ',' << (correct ? 1 : 0) << "\n";
+        }
+    }
+    std::cout << "Результаты сохранены в " << csv_path << "\n";
 }
 
 int main() {
@@ -73,14 +631,26 @@ int main() {
         << THREADS_COUNT << " потоками и "
         << ITERATIONS << " итерациями на каждый поток...\n\n";
 
+    const auto& approaches = all_approaches();
+
     // Тестируем подход без синхронизации
-    test_approach(increment_no_sync, "Без синхронизации");
+    test_approach(approaches[0]);
 
     // Тестируем подход с мьютексом
-    test_approach(increment_mutex, "С мьютексом");
+    test_approach(approaches[1]);
 
     // Тестируем подход с атомарными операциями
-    test_approach(increment_atomic, "Атомарные операции");
+    test_approach(approaches[2]);
+
+    // Тестируем распределенный счетчик
+    test_approach(approaches[3]);
+
+    // Все корректные подходы (без первого) - в бенчмарк конкуренции
+    std::vector<Approach> synchronized(approaches.begin() + 1, approaches.end());
+    benchmark_contention(synchronized, "lab3_contention.csv");
+
+    // Передача работы через очереди
+    benchmark_queues("lab3_queues.csv");
 
     return 0;
 }
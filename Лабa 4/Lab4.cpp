@@ -1,38 +1,56 @@
 #include <iostream>
 #include <vector>
-#include <random>
 #include <chrono>
 #include <iomanip>
+#include <algorithm>
 #include <omp.h>
 #include <windows.h> 
+#include "../common/matrix.h"
+#include "../common/cpu_features.h"
+#include "../common/typed_gemm.h"
+#include "../common/counter_rng.h"
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
 
-// Функция для генерации случайной матрицы
-std::vector<std::vector<double>> generate_random_matrix(int rows, int cols) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<> dis(0.0, 100.0);
+// Старое представление: каждая строка - отдельный вектор (для сравнения)
+using nested_matrix = std::vector<std::vector<double>>;
 
-    std::vector<std::vector<double>> matrix(rows, std::vector<double>(cols));
+// Параметры блочного умножения (GEMM):
+// микроядро считает блок C размером GEMM_MR x GEMM_NR в регистрах,
+// упакованная полоса B (GEMM_KC x GEMM_NR) остается в L1,
+// упакованный блок A (GEMM_MC x GEMM_KC) - в L2, блок B (GEMM_KC x GEMM_NC) - в L3
+const int GEMM_MR = 6;
+const int GEMM_NR = 8;
+const int GEMM_KC = 256;
+const int GEMM_MC = 96;     // Кратно GEMM_MR
+const int GEMM_NC = 4096;   // Кратно GEMM_NR
+const int GEMM_JR_GROUP = 512; // Столбцов C в одной задаче потока (кратно GEMM_NR)
 
+// Размер, начиная с которого подматрицы умножаются блочным GEMM, а не делятся дальше
+const int STRASSEN_CUTOFF = 1024;
+
+// Функция для генерации случайной матрицы: строки заполняются параллельно,
+// элемент (i, j) - число с номером i * cols + j потока seed
+Matrix<double> generate_random_matrix(int rows, int cols, uint64_t seed = random_seed()) {
+    const CounterRng rng(seed);
+    Matrix<double> matrix(rows, cols);
+
+#pragma omp parallel for schedule(static)
     for (int i = 0; i < rows; ++i) {
-        for (int j = 0; j < cols; ++j) {
-            matrix[i][j] = dis(gen);
-        }
+        rng.fill_real(matrix[i], cols, 0.0, 100.0, static_cast<uint64_t>(i) * cols);
     }
 
     return matrix;
 }
 
 // Последовательное умножение матриц
-std::vector<std::vector<double>> matrix_multiply_sequential(
-    const std::vector<std::vector<double>>& A,
-    const std::vector<std::vector<double>>& B) {
+Matrix<double> matrix_multiply_sequential(const Matrix<double>& A, const Matrix<double>& B) {
+    int rows_A = A.rows();
+    int cols_A = A.cols();
+    int cols_B = B.cols();
 
-    int rows_A = A.size();
-    int cols_A = A[0].size();
-    int cols_B = B[0].size();
-
-    std::vector<std::vector<double>> C(rows_A, std::vector<double>(cols_B, 0.0));
+    Matrix<double> C(rows_A, cols_B, 0.0);
 
     for (int i = 0; i < rows_A; ++i) {
         for (int j = 0; j < cols_B; ++j) {
@@ -45,16 +63,13 @@ std::vector<std::vector<double>> matrix_multiply_sequential(
     return C;
 }
 
-// Параллельное умножение матриц с OpenMP
-std::vector<std::vector<double>> matrix_multiply_parallel(
-    const std::vector<std::vector<double>>& A,
-    const std::vector<std::vector<double>>& B) {
-
-    int rows_A = A.size();
-    int cols_A = A[0].size();
-    int cols_B = B[0].size();
+// Параллельное умножение матриц с OpenMP (простой цикл i-j-k)
+Matrix<double> matrix_multiply_parallel_naive(const Matrix<double>& A, const Matrix<double>& B) {
+    int rows_A = A.rows();
+    int cols_A = A.cols();
+    int cols_B = B.cols();
 
-    std::vector<std::vector<double>> C(rows_A, std::vector<double>(cols_B, 0.0));
+    Matrix<double> C(rows_A, cols_B, 0.0);
 
 #pragma omp parallel for shared(A, B, C)
     for (int i = 0; i < rows_A; ++i) {
@@ -71,18 +86,485 @@ std::vector<std::vector<double>> matrix_multiply_parallel(
     return C;
 }
 
-// Проверка корректности результатов (сравнение двух матриц)
-bool verify_results(
-    const std::vector<std::vector<double>>& A,
-    const std::vector<std::vector<double>>& B,
-    double epsilon = 1e-6) {
+// Микроядро: C[GEMM_MR x GEMM_NR] += A_packed * B_packed по kc шагам
+using GemmKernel = void (*)(int kc, const double* a, const double* b, double* c, size_t ldc);
+
+// Переносимое микроядро (компилятор векторизует его базовым набором инструкций)
+void gemm_kernel_scalar(int kc, const double* a, const double* b, double* c, size_t ldc) {
+    double acc[GEMM_MR][GEMM_NR] = {};
+    for (int p = 0; p < kc; ++p) {
+        for (int r = 0; r < GEMM_MR; ++r) {
+            for (int j = 0; j < GEMM_NR; ++j) {
+                acc[r][j] += a[r] * b[j];
+            }
+        }
+        a += GEMM_MR;
+        b += GEMM_NR;
+    }
+    for (int r = 0; r < GEMM_MR; ++r) {
+        for (int j = 0; j < GEMM_NR; ++j) {
+            c[r * ldc + j] += acc[r][j];
+        }
+    }
+}
+
+#ifdef CPU_X86
+/*
+ * Микроядро AVX2/FMA 6x8: 12 регистров-аккумуляторов (6 строк по 2 вектора
+ * из 4 double), на каждом шаге k - 2 загрузки B, 6 рассылок A и 12 FMA.
+ * Упакованные A и B выровнены по 64 байта, поэтому загрузки B выровненные.
+ */
+TARGET_AVX2 void gemm_kernel_avx2(int kc, const double* a, const double* b, double* c, size_t ldc) {
+    __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+    __m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+    __m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+    __m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+    __m256d c40 = _mm256_setzero_pd(), c41 = _mm256_setzero_pd();
+    __m256d c50 = _mm256_setzero_pd(), c51 = _mm256_setzero_pd();
+
+    // Строки C понадобятся в конце, упакованные A и B читаются с опережением
+    for (int r = 0; r < GEMM_MR; ++r) _mm_prefetch(reinterpret_cast<const char*>(c + r * ldc), _MM_HINT_T0);
+    for (int p = 0; p < kc; ++p) {
+        _mm_prefetch(reinterpret_cast<const char*>(a + 8 * GEMM_MR), _MM_HINT_T0);
+        _mm_prefetch(reinterpret_cast<const char*>(b + 8 * GEMM_NR), _MM_HINT_T0);
+        const __m256d b0 = _mm256_load_pd(b);
+        const __m256d b1 = _mm256_load_pd(b + 4);
+        __m256d ar;
+        ar = _mm256_broadcast_sd(a + 0); c00 = _mm256_fmadd_pd(ar, b0, c00); c01 = _mm256_fmadd_pd(ar, b1, c01);
+        ar = _mm256_broadcast_sd(a + 1); c10 = _mm256_fmadd_pd(ar, b0, c10); c11 = _mm256_fmadd_pd(ar, b1, c11);
+        ar = _mm256_broadcast_sd(a + 2); c20 = _mm256_fmadd_pd(ar, b0, c20); c21 = _mm256_fmadd_pd(ar, b1, c21);
+        ar = _mm256_broadcast_sd(a + 3); c30 = _mm256_fmadd_pd(ar, b0, c30); c31 = _mm256_fmadd_pd(ar, b1, c31);
+        ar = _mm256_broadcast_sd(a + 4); c40 = _mm256_fmadd_pd(ar, b0, c40); c41 = _mm256_fmadd_pd(ar, b1, c41);
+        ar = _mm256_broadcast_sd(a + 5); c50 = _mm256_fmadd_pd(ar, b0, c50); c51 = _mm256_fmadd_pd(ar, b1, c51);
+        a += GEMM_MR;
+        b += GEMM_NR;
+    }
+
+    const __m256d rows[GEMM_MR][2] = { { c00, c01 }, { c10, c11 }, { c20, c21 }, { c30, c31 }, { c40, c41 }, { c50, c51 } };
+    for (int r = 0; r < GEMM_MR; ++r) {
+        double* row = c + r * ldc;
+        _mm256_storeu_pd(row, _mm256_add_pd(_mm256_loadu_pd(row), rows[r][0]));
+        _mm256_storeu_pd(row + 4, _mm256_add_pd(_mm256_loadu_pd(row + 4), rows[r][1]));
+    }
+}
+#endif
+
+// Микроядро для текущего процессора (выбирается один раз)
+GemmKernel gemm_kernel() {
+#ifdef CPU_X86
+    static const GemmKernel kernel = cpu_features().avx2 && cpu_features().fma ? gemm_kernel_avx2 : gemm_kernel_scalar;
+#else
+    static const GemmKernel kernel = gemm_kernel_scalar;
+#endif
+    return kernel;
+}
+
+const char* gemm_kernel_name() {
+    return gemm_kernel() == gemm_kernel_scalar ? "скалярное" : "AVX2/FMA";
+}
+
+/*
+ * Упаковка блока A (mc x kc) в полосы по GEMM_MR строк: в полосе элементы
+ * идут по k, для каждого k - GEMM_MR значений подряд (недостающие строки - нули)
+ */
+void pack_a(MatrixView<const double> A, int mc, int kc, double* packed) {
+    for (int i0 = 0; i0 < mc; i0 += GEMM_MR) {
+        const int rows = std::min(GEMM_MR, mc - i0);
+        for (int p = 0; p < kc; ++p) {
+            for (int r = 0; r < GEMM_MR; ++r) {
+                *packed++ = r < rows ? A[i0 + r][p] : 0.0;
+            }
+        }
+    }
+}
+
+/*
+ * Упаковка полосы B (kc x GEMM_NR) начиная со столбца j0: для каждого k -
+ * GEMM_NR значений подряд (недостающие столбцы - нули)
+ */
+void pack_b_panel(MatrixView<const double> B, int kc, int j0, double* packed) {
+    const int cols = std::min(GEMM_NR, static_cast<int>(B.cols()) - j0);
+    for (int p = 0; p < kc; ++p) {
+        const double* row = B[p] + j0;
+        for (int j = 0; j < GEMM_NR; ++j) {
+            packed[j] = j < cols ? row[j] : 0.0;
+        }
+        packed += GEMM_NR;
+    }
+}
+
+/*
+ * Блочное умножение с упаковкой: C += A * B
+ * Циклы по блокам NC (столбцы B) и KC (общая размерность); для каждой пары
+ * потоки вместе упаковывают блок B, затем разбирают задачи
+ * "блок строк MC x группа столбцов GEMM_JR_GROUP", упаковывают свой блок A
+ * и считают его микроядром по полосам GEMM_MR x GEMM_NR.
+ * threads - число потоков (1 - вызов внутри уже параллельной задачи)
+ */
+void gemm(MatrixView<const double> A, MatrixView<const double> B, MatrixView<double> C,
+    int threads = omp_get_max_threads()) {
+    const int m = A.rows();
+    const int k = A.cols();
+    const int n = B.cols();
+    if (m == 0 || n == 0 || k == 0) return;
+
+    const GemmKernel kernel = gemm_kernel();
+    const int nc_max = std::min(GEMM_NC, (n + GEMM_NR - 1) / GEMM_NR * GEMM_NR);
+    Matrix<double> packed_b(1, static_cast<size_t>(GEMM_KC) * nc_max);
+    Matrix<double> packed_a(threads, static_cast<size_t>(GEMM_MC) * GEMM_KC);
+
+#pragma omp parallel num_threads(threads)
+    {
+        double* a_buffer = packed_a[omp_get_thread_num()];
+        alignas(64) double edge[GEMM_MR * GEMM_NR];
+
+        for (int jc = 0; jc < n; jc += GEMM_NC) {
+            const int nc = std::min(GEMM_NC, n - jc);
+            const int b_panels = (nc + GEMM_NR - 1) / GEMM_NR;
+            for (int pc = 0; pc < k; pc += GEMM_KC) {
+                const int kc = std::min(GEMM_KC, k - pc);
+                MatrixView<const double> B_block = B.block(pc, jc, kc, nc);
+
+#pragma omp for schedule(static)
+                for (int jp = 0; jp < b_panels; ++jp) {
+                    pack_b_panel(B_block, kc, jp * GEMM_NR, packed_b[0] + static_cast<size_t>(jp) * kc * GEMM_NR);
+                }
+
+                const int row_blocks = (m + GEMM_MC - 1) / GEMM_MC;
+                const int col_groups = (nc + GEMM_JR_GROUP - 1) / GEMM_JR_GROUP;
+                int packed_ic = -1;
 
-    if (A.size() != B.size() || A[0].size() != B[0].size()) {
+#pragma omp for schedule(dynamic)
+                for (int task = 0; task < row_blocks * col_groups; ++task) {
+                    const int ic = task / col_groups * GEMM_MC;
+                    const int mc = std::min(GEMM_MC, m - ic);
+                    if (ic != packed_ic) {
+                        pack_a(A.block(ic, pc, mc, kc), mc, kc, a_buffer);
+                        packed_ic = ic;
+                    }
+
+                    const int jr_begin = task % col_groups * GEMM_JR_GROUP;
+                    const int jr_end = std::min(nc, jr_begin + GEMM_JR_GROUP);
+                    for (int jr = jr_begin; jr < jr_end; jr += GEMM_NR) {
+                        const double* b_panel = packed_b[0] + static_cast<size_t>(jr / GEMM_NR) * kc * GEMM_NR;
+                        const int nr = std::min(GEMM_NR, nc - jr);
+                        for (int ir = 0; ir < mc; ir += GEMM_MR) {
+                            const double* a_panel = a_buffer + static_cast<size_t>(ir) * kc;
+                            const int mr = std::min(GEMM_MR, mc - ir);
+                            double* c = C[ic + ir] + jc + jr;
+                            if (mr == GEMM_MR && nr == GEMM_NR) {
+                                kernel(kc, a_panel, b_panel, c, C.ld());
+                                continue;
+                            }
+                            // Краевой блок: считаем во временный буфер и добавляем нужную часть
+                            std::fill(edge, edge + GEMM_MR * GEMM_NR, 0.0);
+                            kernel(kc, a_panel, b_panel, edge, GEMM_NR);
+                            for (int r = 0; r < mr; ++r) {
+                                for (int j = 0; j < nr; ++j) {
+                                    c[r * C.ld() + j] += edge[r * GEMM_NR + j];
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Параллельное умножение матриц: блочный GEMM с упаковкой и SIMD-микроядром
+Matrix<double> matrix_multiply_parallel(const Matrix<double>& A, const Matrix<double>& B) {
+    Matrix<double> C(A.rows(), B.cols(), 0.0);
+    gemm(A.view(), B.view(), C.view());
+    return C;
+}
+
+// Копия матрицы в другом типе элементов (для целых типов - с округлением)
+template <typename T>
+Matrix<T> convert_matrix(const Matrix<double>& M) {
+    Matrix<T> result(M.rows(), M.cols());
+    for (size_t i = 0; i < M.rows(); ++i) {
+        for (size_t j = 0; j < M.cols(); ++j) {
+            result[i][j] = static_cast<T>(std::is_integral<T>::value ? std::round(M[i][j]) : M[i][j]);
+        }
+    }
+    return result;
+}
+
+// Умножение с типом элемента T и типом накопления Acc (float, int16 -> int32, int8 -> int32 векторизованы)
+template <typename T, typename Acc>
+Matrix<Acc> matrix_multiply_typed(const Matrix<T>& A, const Matrix<T>& B) {
+    Matrix<Acc> C(A.rows(), B.cols(), Acc());
+    gemm_typed<T, Acc>(A.rows(), B.cols(), A.cols(), A.data(), A.ld(), B.data(), B.ld(), C.data(), C.ld());
+    return C;
+}
+
+/*
+ * Алгоритм Штрассена: 7 произведений половинных блоков вместо 8
+ *   M1 = (A11 + A22)(B11 + B22)   M2 = (A21 + A22) B11   M3 = A11 (B12 - B22)
+ *   M4 = A22 (B21 - B11)          M5 = (A11 + A12) B22   M6 = (A21 - A11)(B11 + B12)
+ *   M7 = (A12 - A22)(B21 + B22)
+ *   C11 = M1 + M4 - M5 + M7   C12 = M3 + M5   C21 = M2 + M4   C22 = M1 - M2 + M3 + M6
+ * Квадранты нумеруются 0 = 11, 1 = 12, 2 = 21, 3 = 22.
+ */
+struct StrassenOperand {
+    int first;  // Квадрант
+    int second; // Второй квадрант или -1
+    double sign;
+};
+
+const StrassenOperand STRASSEN_LEFT[7] = {
+    { 0, 3, 1 }, { 2, 3, 1 }, { 0, -1, 0 }, { 3, -1, 0 }, { 0, 1, 1 }, { 2, 0, -1 }, { 1, 3, -1 } };
+const StrassenOperand STRASSEN_RIGHT[7] = {
+    { 0, 3, 1 }, { 0, -1, 0 }, { 1, 3, -1 }, { 2, 0, -1 }, { 3, -1, 0 }, { 0, 1, 1 }, { 2, 3, 1 } };
+// Вклад M_i в квадрант C
+const int STRASSEN_COMBINE[7][4] = {
+    { 1, 0, 0, 1 }, { 0, 0, 1, -1 }, { 0, 1, 0, 1 }, { 1, 0, 1, 0 }, { -1, 1, 0, 0 }, { 0, 0, 0, 1 }, { 1, 0, 0, 0 } };
+
+template <typename T>
+MatrixView<T> quadrant(MatrixView<T> M, int q) {
+    const size_t h = M.rows() / 2;
+    return M.block(q / 2 * h, q % 2 * h, h, h);
+}
+
+// out = X + sign * Y
+void add_views(MatrixView<const double> X, MatrixView<const double> Y, double sign, MatrixView<double> out) {
+    for (size_t i = 0; i < out.rows(); ++i) {
+        const double* x = X[i];
+        const double* y = Y[i];
+        double* o = out[i];
+#pragma omp simd
+        for (size_t j = 0; j < out.cols(); ++j) {
+            o[j] = x[j] + sign * y[j];
+        }
+    }
+}
+
+// out = coefficient * M (assign) или out += coefficient * M
+void accumulate_view(MatrixView<const double> M, int coefficient, bool assign, MatrixView<double> out) {
+    for (size_t i = 0; i < out.rows(); ++i) {
+        const double* m = M[i];
+        double* o = out[i];
+        if (assign) {
+#pragma omp simd
+            for (size_t j = 0; j < out.cols(); ++j) o[j] = coefficient * m[j];
+        }
+        else {
+#pragma omp simd
+            for (size_t j = 0; j < out.cols(); ++j) o[j] += coefficient * m[j];
+        }
+    }
+}
+
+// Операнд произведения: сам квадрант или сумма двух квадрантов в temp
+MatrixView<const double> strassen_operand(MatrixView<const double> M, const StrassenOperand& op, double* temp) {
+    if (op.second < 0) return quadrant(M, op.first);
+    const size_t h = M.rows() / 2;
+    MatrixView<double> out(temp, h, h, h);
+    add_views(quadrant(M, op.first), quadrant(M, op.second), op.sign, out);
+    return out;
+}
+
+// Рабочая память последовательной рекурсии для размера n и levels уровней
+size_t strassen_serial_workspace(size_t n, int levels) {
+    if (levels == 0) return 0;
+    const size_t h = n / 2;
+    return 3 * h * h + strassen_serial_workspace(h, levels - 1);
+}
+
+/*
+ * Последовательная рекурсия Штрассена (внутри одной задачи): C = A * B.
+ * На каждом уровне из workspace берутся три блока h x h (левый операнд,
+ * правый операнд, произведение), произведение сразу добавляется в квадранты C,
+ * остаток workspace передается следующему уровню. На нижнем уровне - GEMM
+ * с leaf_threads потоками.
+ */
+void strassen_serial(MatrixView<const double> A, MatrixView<const double> B, MatrixView<double> C,
+    int levels, double* workspace, int leaf_threads) {
+    if (levels == 0) {
+        for (size_t i = 0; i < C.rows(); ++i) std::fill(C[i], C[i] + C.cols(), 0.0);
+        gemm(A, B, C, leaf_threads);
+        return;
+    }
+    const size_t h = A.rows() / 2;
+    double* left = workspace;
+    double* right = left + h * h;
+    MatrixView<double> product(right + h * h, h, h, h);
+    double* rest = right + 2 * h * h;
+
+    bool assigned[4] = { false, false, false, false };
+    for (int i = 0; i < 7; ++i) {
+        MatrixView<const double> L = strassen_operand(A, STRASSEN_LEFT[i], left);
+        MatrixView<const double> R = strassen_operand(B, STRASSEN_RIGHT[i], right);
+        strassen_serial(L, R, product, levels - 1, rest, leaf_threads);
+        for (int q = 0; q < 4; ++q) {
+            if (STRASSEN_COMBINE[i][q] == 0) continue;
+            accumulate_view(product, STRASSEN_COMBINE[i][q], !assigned[q], quadrant(C, q));
+            assigned[q] = true;
+        }
+    }
+}
+
+/*
+ * Умножение квадратных матриц рекурсивным алгоритмом Штрассена (для больших n).
+ * Размер дополняется нулями до size * 2^levels, где size <= cutoff.
+ * Верхний уровень: 7 произведений считаются задачами OpenMP, у каждой
+ * свои операнды, результат и рабочая память последовательной рекурсии
+ * в одном заранее выделенном буфере; подматрицы размера <= cutoff
+ * умножаются блочным GEMM, потоки делятся между задачами поровну.
+ * Неквадратные матрицы и n <= cutoff умножаются matrix_multiply_parallel.
+ */
+Matrix<double> matrix_multiply_strassen(const Matrix<double>& A, const Matrix<double>& B, int cutoff = STRASSEN_CUTOFF) {
+    const size_t n = A.rows();
+    if (A.cols() != n || B.rows() != n || B.cols() != n || n <= static_cast<size_t>(cutoff)) {
+        return matrix_multiply_parallel(A, B);
+    }
+
+    int levels = 0;
+    size_t size = n;
+    while (size > static_cast<size_t>(cutoff)) {
+        size = (size + 1) / 2;
+        ++levels;
+    }
+    const size_t padded = size << levels;
+    const size_t h = padded / 2;
+
+    // Дополнение нулями, если n не делится на 2^levels
+    Matrix<double> A_padded, B_padded, C(padded, padded, 0.0);
+    MatrixView<const double> A_view = A.view(), B_view = B.view();
+    if (padded != n) {
+        A_padded = Matrix<double>(padded, padded, 0.0);
+        B_padded = Matrix<double>(padded, padded, 0.0);
+        for (size_t i = 0; i < n; ++i) {
+            std::copy(A[i], A[i] + n, A_padded[i]);
+            std::copy(B[i], B[i] + n, B_padded[i]);
+        }
+        A_view = A_padded.view();
+        B_view = B_padded.view();
+    }
+
+    // Рабочая память: для каждой задачи - суммы операндов (если нужны), M_i и рекурсия
+    const size_t serial = strassen_serial_workspace(h, levels - 1);
+    size_t offsets[7][4]; // Левый операнд, правый операнд, M_i, рекурсия
+    size_t total = 0;
+    for (int i = 0; i < 7; ++i) {
+        offsets[i][0] = total;
+        total += STRASSEN_LEFT[i].second >= 0 ? h * h : 0;
+        offsets[i][1] = total;
+        total += STRASSEN_RIGHT[i].second >= 0 ? h * h : 0;
+        offsets[i][2] = total;
+        total += h * h;
+        offsets[i][3] = total;
+        total += serial;
+    }
+    Matrix<double> workspace(1, total);
+    double* base = workspace.data();
+
+    const int threads = omp_get_max_threads();
+    const int leaf_threads = std::max(1, threads / 7);
+    const int saved_levels = omp_get_max_active_levels();
+    omp_set_max_active_levels(2);
+
+#pragma omp parallel num_threads(std::min(threads, 7))
+#pragma omp single
+    for (int i = 0; i < 7; ++i) {
+#pragma omp task firstprivate(i)
+        {
+            MatrixView<const double> L = strassen_operand(A_view, STRASSEN_LEFT[i], base + offsets[i][0]);
+            MatrixView<const double> R = strassen_operand(B_view, STRASSEN_RIGHT[i], base + offsets[i][1]);
+            MatrixView<double> product(base + offsets[i][2], h, h, h);
+            strassen_serial(L, R, product, levels - 1, base + offsets[i][3], leaf_threads);
+        }
+    }
+    omp_set_max_active_levels(saved_levels);
+
+    // Сборка квадрантов C из M_1 .. M_7 (строки делятся между потоками)
+    MatrixView<double> C_view = C.view();
+#pragma omp parallel for
+    for (long long row = 0; row < static_cast<long long>(h); ++row) {
+        for (int q = 0; q < 4; ++q) {
+            MatrixView<double> out = quadrant(C_view, q).block(row, 0, 1, h);
+            for (int i = 0; i < 7; ++i) {
+                if (STRASSEN_COMBINE[i][q] == 0) continue;
+                MatrixView<const double> product(base + offsets[i][2] + row * h, 1, h, h);
+                accumulate_view(product, STRASSEN_COMBINE[i][q], false, out);
+            }
+        }
+    }
+
+    if (padded == n) return C;
+    Matrix<double> result(n, n);
+    for (size_t i = 0; i < n; ++i) {
+        std::copy(C[i], C[i] + n, result[i]);
+    }
+    return result;
+}
+
+/*
+ * Оценка пиковой производительности (GFLOP/s): каждый поток выполняет
+ * независимые FMA в регистрах тем же набором инструкций, что микроядро
+ */
+#ifdef CPU_X86
+TARGET_AVX2 double fma_loop_avx2(long long iterations) {
+    __m256d a0 = _mm256_set1_pd(0), a1 = _mm256_set1_pd(1), a2 = _mm256_set1_pd(2), a3 = _mm256_set1_pd(3);
+    __m256d a4 = _mm256_set1_pd(4), a5 = _mm256_set1_pd(5), a6 = _mm256_set1_pd(6), a7 = _mm256_set1_pd(7);
+    __m256d a8 = _mm256_set1_pd(8), a9 = _mm256_set1_pd(9), a10 = _mm256_set1_pd(10), a11 = _mm256_set1_pd(11);
+    const __m256d x = _mm256_set1_pd(0.999999), y = _mm256_set1_pd(1e-7);
+    for (long long i = 0; i < iterations; ++i) {
+        a0 = _mm256_fmadd_pd(a0, x, y); a1 = _mm256_fmadd_pd(a1, x, y); a2 = _mm256_fmadd_pd(a2, x, y);
+        a3 = _mm256_fmadd_pd(a3, x, y); a4 = _mm256_fmadd_pd(a4, x, y); a5 = _mm256_fmadd_pd(a5, x, y);
+        a6 = _mm256_fmadd_pd(a6, x, y); a7 = _mm256_fmadd_pd(a7, x, y); a8 = _mm256_fmadd_pd(a8, x, y);
+        a9 = _mm256_fmadd_pd(a9, x, y); a10 = _mm256_fmadd_pd(a10, x, y); a11 = _mm256_fmadd_pd(a11, x, y);
+    }
+    __m256d sum = _mm256_add_pd(_mm256_add_pd(_mm256_add_pd(a0, a1), _mm256_add_pd(a2, a3)),
+        _mm256_add_pd(_mm256_add_pd(a4, a5), _mm256_add_pd(a6, a7)));
+    sum = _mm256_add_pd(sum, _mm256_add_pd(_mm256_add_pd(a8, a9), _mm256_add_pd(a10, a11)));
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, sum);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+#endif
+
+double fma_loop_scalar(long long iterations) {
+    double acc[12];
+    for (int r = 0; r < 12; ++r) acc[r] = r;
+    for (long long i = 0; i < iterations; ++i) {
+        for (int r = 0; r < 12; ++r) acc[r] = acc[r] * 0.999999 + 1e-7;
+    }
+    double sum = 0.0;
+    for (int r = 0; r < 12; ++r) sum += acc[r];
+    return sum;
+}
+
+double peak_gflops() {
+    const long long iterations = 20'000'000;
+    const bool avx2 = gemm_kernel() != gemm_kernel_scalar;
+    const double flops_per_iteration = avx2 ? 12 * 4 * 2 : 12 * 2;
+    double checksum = 0.0;
+
+    auto start = std::chrono::high_resolution_clock::now();
+#pragma omp parallel reduction(+:checksum)
+    {
+#ifdef CPU_X86
+        checksum += avx2 ? fma_loop_avx2(iterations) : fma_loop_scalar(iterations);
+#else
+        checksum += fma_loop_scalar(iterations);
+#endif
+    }
+    std::chrono::duration<double> time = std::chrono::high_resolution_clock::now() - start;
+    if (checksum == 0.0) std::cout << ""; // Результат используется, цикл не удаляется
+
+    return omp_get_max_threads() * flops_per_iteration * iterations / time.count() / 1e9;
+}
+
+// Проверка корректности результатов (сравнение двух матриц)
+bool verify_results(const Matrix<double>& A, const Matrix<double>& B, double epsilon = 1e-6) {
+    if (A.rows() != B.rows() || A.cols() != B.cols()) {
         return false;
     }
 
-    for (size_t i = 0; i < A.size(); ++i) {
-        for (size_t j = 0; j < A[0].size(); ++j) {
+    for (size_t i = 0; i < A.rows(); ++i) {
+        for (size_t j = 0; j < A.cols(); ++j) {
             if (std::abs(A[i][j] - B[i][j]) > epsilon) {
                 return false;
             }
@@ -92,6 +574,188 @@ bool verify_results(
     return true;
 }
 
+// Копия матрицы в старом представлении (вектор векторов)
+nested_matrix to_nested(const Matrix<double>& M) {
+    nested_matrix result(M.rows(), std::vector<double>(M.cols()));
+    for (size_t i = 0; i < M.rows(); ++i) {
+        std::copy(M[i], M[i] + M.cols(), result[i].begin());
+    }
+    return result;
+}
+
+// Параллельное умножение в старом представлении (тот же цикл, что matrix_multiply_parallel_naive)
+nested_matrix matrix_multiply_parallel_nested(const nested_matrix& A, const nested_matrix& B) {
+    int rows_A = A.size();
+    int cols_A = A[0].size();
+    int cols_B = B[0].size();
+
+    nested_matrix C(rows_A, std::vector<double>(cols_B, 0.0));
+
+#pragma omp parallel for shared(A, B, C)
+    for (int i = 0; i < rows_A; ++i) {
+        for (int j = 0; j < cols_B; ++j) {
+            double sum = 0.0;
+
+            for (int k = 0; k < cols_A; ++k) {
+                sum += A[i][k] * B[k][j];
+            }
+            C[i][j] = sum;
+        }
+    }
+
+    return C;
+}
+
+/*
+ * Сравнение хранения матриц "до" (вектор векторов) и "после" (Matrix<double>,
+ * один выровненный буфер) на одном и том же параллельном ядре i-j-k.
+ * Порядок операций одинаков, поэтому результаты должны совпасть точно.
+ */
+void benchmark_storage() {
+    std::cout << "\nСравнение хранения матриц (параллельное умножение):" << std::endl;
+    for (int n : { 500, 2000, 4000 }) {
+        auto A = generate_random_matrix(n, n);
+        auto B = generate_random_matrix(n, n);
+        auto A_nested = to_nested(A);
+        auto B_nested = to_nested(B);
+
+        auto start = std::chrono::high_resolution_clock::now();
+        auto C_nested = matrix_multiply_parallel_nested(A_nested, B_nested);
+        std::chrono::duration<double> nested_time = std::chrono::high_resolution_clock::now() - start;
+
+        start = std::chrono::high_resolution_clock::now();
+        auto C = matrix_multiply_parallel_naive(A, B);
+        std::chrono::duration<double> matrix_time = std::chrono::high_resolution_clock::now() - start;
+
+        bool same = true;
+        for (int i = 0; i < n && same; ++i) {
+            same = std::equal(C[i], C[i] + n, C_nested[i].begin());
+        }
+
+        std::cout << n << "x" << n << ": вектор векторов " << std::fixed << std::setprecision(4)
+            << nested_time.count() << " сек, Matrix " << matrix_time.count() << " сек, ускорение "
+            << std::setprecision(2) << nested_time.count() / matrix_time.count() << "x, результаты "
+            << (same ? "совпадают" : "не совпадают") << std::endl;
+    }
+}
+
+/*
+ * Блочный GEMM на матрицах 2000 x 2000: GFLOP/s, доля от измеренного пика
+ * и проверка по последовательному умножению
+ */
+void benchmark_gemm() {
+    const int n = 2000;
+    std::cout << "\nБлочное умножение " << n << "x" << n << " (микроядро " << gemm_kernel_name()
+        << ", потоков " << omp_get_max_threads() << "):" << std::endl;
+    auto A = generate_random_matrix(n, n);
+    auto B = generate_random_matrix(n, n);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    auto C = matrix_multiply_parallel(A, B);
+    std::chrono::duration<double> gemm_time = std::chrono::high_resolution_clock::now() - start;
+
+    double gflops = 2.0 * n * n * n / gemm_time.count() / 1e9;
+    double peak = peak_gflops();
+    std::cout << "Время: " << std::fixed << std::setprecision(4) << gemm_time.count() << " сек, "
+        << std::setprecision(2) << gflops << " GFLOP/s, пик " << peak << " GFLOP/s ("
+        << 100.0 * gflops / peak << "% от пика)" << std::endl;
+
+    std::cout << "Последовательное умножение для проверки..." << std::endl;
+    auto C_seq = matrix_multiply_sequential(A, B);
+    bool is_correct = verify_results(C_seq, C);
+    std::cout << "Результаты " << (is_correct ? "совпадают" : "не совпадают") << std::endl;
+}
+
+/*
+ * Штрассен против блочного GEMM: время на большой матрице и погрешность
+ * относительно matrix_multiply_sequential (на меньшей матрице с тремя уровнями
+ * рекурсии, так как эталон медленный)
+ */
+void benchmark_strassen() {
+    std::cout << "\nАлгоритм Штрассена (порог " << STRASSEN_CUTOFF << "):" << std::endl;
+    for (int n : { 4096, 8192 }) {
+        auto A = generate_random_matrix(n, n);
+        auto B = generate_random_matrix(n, n);
+
+        auto start = std::chrono::high_resolution_clock::now();
+        auto C_gemm = matrix_multiply_parallel(A, B);
+        std::chrono::duration<double> gemm_time = std::chrono::high_resolution_clock::now() - start;
+
+        start = std::chrono::high_resolution_clock::now();
+        auto C_strassen = matrix_multiply_strassen(A, B);
+        std::chrono::duration<double> strassen_time = std::chrono::high_resolution_clock::now() - start;
+
+        std::cout << n << "x" << n << ": GEMM " << std::fixed << std::setprecision(4) << gemm_time.count()
+            << " сек, Штрассен " << strassen_time.count() << " сек, ускорение " << std::setprecision(2)
+            << gemm_time.count() / strassen_time.count() << "x" << std::endl;
+    }
+
+    const int n = 2048;
+    auto A = generate_random_matrix(n, n);
+    auto B = generate_random_matrix(n, n);
+    auto C_strassen = matrix_multiply_strassen(A, B, n / 8);
+    std::cout << "Последовательное умножение " << n << "x" << n << " для проверки..." << std::endl;
+    auto C_seq = matrix_multiply_sequential(A, B);
+
+    double max_error = 0.0, max_value = 0.0;
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            max_error = std::max(max_error, std::abs(C_seq[i][j] - C_strassen[i][j]));
+            max_value = std::max(max_value, std::abs(C_seq[i][j]));
+        }
+    }
+    std::cout << std::scientific << std::setprecision(3) << "Максимальная погрешность (3 уровня): " << max_error
+        << ", относительная " << max_error / max_value << std::endl;
+    std::cout << "Результаты " << (verify_results(C_seq, C_strassen) ? "совпадают" : "не совпадают")
+        << " (допуск 1e-6)" << std::endl;
+}
+
+// Один тип в сравнении точности: время, GOPS и погрешность относительно double
+template <typename T, typename Acc>
+void benchmark_type(const char* name, const Matrix<double>& A, const Matrix<double>& B, const Matrix<double>& C_ref) {
+    const size_t n = A.rows();
+    auto A_typed = convert_matrix<T>(A);
+    auto B_typed = convert_matrix<T>(B);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    auto C = matrix_multiply_typed<T, Acc>(A_typed, B_typed);
+    std::chrono::duration<double> time = std::chrono::high_resolution_clock::now() - start;
+
+    double max_error = 0.0, max_value = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            max_error = std::max(max_error, std::abs(static_cast<double>(C[i][j]) - C_ref[i][j]));
+            max_value = std::max(max_value, std::abs(C_ref[i][j]));
+        }
+    }
+    std::cout << name << " (" << sizeof(T) << " байт, ядро " << typed_kernel<T, Acc>().name << "): "
+        << std::fixed << std::setprecision(4) << time.count() << " сек, " << std::setprecision(2)
+        << 2.0 * n * n * n / time.count() / 1e9 << " GOPS, отн. погрешность " << std::scientific
+        << std::setprecision(3) << max_error / max_value << std::defaultfloat << std::endl;
+}
+
+/*
+ * Умножение 2000 x 2000 в разных типах: double (блочный GEMM) - эталон,
+ * float, int16 и int8 с накоплением в int32. Целые типы получают округленные
+ * элементы, поэтому их погрешность - погрешность квантования данных.
+ */
+void benchmark_typed() {
+    const int n = 2000;
+    std::cout << "\nУмножение " << n << "x" << n << " в разных типах:" << std::endl;
+    auto A = generate_random_matrix(n, n);
+    auto B = generate_random_matrix(n, n);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    auto C_ref = matrix_multiply_parallel(A, B);
+    std::chrono::duration<double> time = std::chrono::high_resolution_clock::now() - start;
+    std::cout << "double (8 байт, блочный GEMM): " << std::fixed << std::setprecision(4) << time.count()
+        << " сек, " << std::setprecision(2) << 2.0 * n * n * n / time.count() / 1e9 << " GOPS" << std::defaultfloat << std::endl;
+
+    benchmark_type<float, float>("float", A, B, C_ref);
+    benchmark_type<int16_t, int32_t>("int16 -> int32", A, B, C_ref);
+    benchmark_type<int8_t, int32_t>("int8 -> int32", A, B, C_ref);
+}
+
 int main() {
     SetConsoleOutputCP(CP_UTF8);
     setlocale(LC_ALL, "Russian");
@@ -132,5 +796,10 @@ int main() {
         << seq_time.count() / par_time.count() << "x" << std::endl;
     std::cout << "Результаты " << (is_correct ? "совпадают" : "не совпадают") << std::endl;
 
+    benchmark_storage();
+    benchmark_gemm();
+    benchmark_strassen();
+    benchmark_typed();
+
     return 0;
 }
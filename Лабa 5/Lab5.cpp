@@ -2,7 +2,51 @@
 #include <vector>
 #include <algorithm>
 #include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <iomanip>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
 #include <omp.h>
+#include "../common/counter_rng.h"
+
+// Начальное значение генератора входных данных: массивы одинаковы при любом числе потоков
+const uint64_t RANDOM_SEED = 42;
+// Поразрядная сортировка: разряд из 8 бит, 256 корзин
+const int RADIX_BITS = 8;
+const int RADIX_BUCKETS = 1 << RADIX_BITS;
+// Буфер записи на корзину: 16 элементов int = одна строка кэша
+const int RADIX_BUFFER_SIZE = 16;
+// Диапазон ключей, при котором выполняется сортировка подсчетом
+const uint32_t COUNTING_SORT_MAX_RANGE = 1 << 16;
+// Массивы меньше этого размера сортируются std::sort
+const size_t RADIX_MIN_SIZE = 2048;
+// Сортировка слиянием: части не длиннее этого размера сортируются вставками
+const ptrdiff_t MERGE_SORT_INSERTION_SIZE = 32;
+// Части короче этого размера сортируются и сливаются без создания задач
+const ptrdiff_t MERGE_SORT_TASK_SIZE = 1 << 14;
+// Число элементов для замера масштабируемости сортировки слиянием
+const int MERGE_SORT_BENCHMARK_SIZE = 100000000;
+// Число записей для проверки сортировки по компаратору
+const int RECORD_BENCHMARK_SIZE = 10000000;
+// Внешняя сортировка: элементов в одной серии (64 МБ)
+const size_t EXTERNAL_RUN_SIZE = size_t(1) << 24;
+// Наименьший блок чтения и записи при слиянии серий (64 КБ)
+const size_t EXTERNAL_MIN_BLOCK_SIZE = size_t(1) << 14;
+// Наибольшее число серий, сливаемых за один проход
+const size_t EXTERNAL_MAX_FAN_IN = 128;
+// Размер тестового файла для внешней сортировки и размер серии в тесте
+const size_t EXTERNAL_TEST_SIZE = 50000000;
+const size_t EXTERNAL_TEST_RUN_SIZE = size_t(1) << 23;
+// Четно-нечетная сортировка O(n^2) замеряется только до этого размера
+const size_t ODD_EVEN_BENCHMARK_MAX_SIZE = 100000;
 
 // Последовательная версия четно-нечетной сортировки
 void oddEvenSortSequential(std::vector<int>& arr) {
@@ -30,46 +74,685 @@ void oddEvenSortSequential(std::vector<int>& arr) {
     }
 }
 
-// Параллельная версия четно-нечетной сортировки с OpenMP
+/*
+ * Граница i-го из parts блоков массива длины n. Все блоки, кроме последних,
+ * имеют одинаковую длину ceil(n / parts): это равносильно дополнению массива
+ * до равных блоков элементами "+бесконечность" в конце, поэтому для
+ * сортировки достаточно parts фаз слияния-разделения.
+ */
+size_t blockBorder(size_t n, int parts, int i) {
+    size_t blockSize = (n + parts - 1) / parts;
+    return std::min(n, blockSize * i);
+}
+
+/*
+ * Параллельная блочная четно-нечетная сортировка (слияние-разделение).
+ * Массив делится на p непрерывных блоков по числу потоков, каждый поток сортирует
+ * свой блок, затем выполняется p фаз: в четной фазе объединяются пары блоков
+ * (0,1), (2,3), ..., в нечетной - (1,2), (3,4), ... Левый поток пары сливает
+ * блоки с начала и оставляет себе меньшие элементы, правый сливает с конца и
+ * оставляет большие. Результат фазы пишется во второй буфер, после чего
+ * буферы меняются местами. Вся сортировка выполняется в одной параллельной
+ * области, фазы разделены барьерами, критических секций нет.
+ */
 void oddEvenSortParallel(std::vector<int>& arr) {
-    bool isSorted = false;
-    int n = arr.size();
+    size_t n = arr.size();
+    if (n < 2) return;
+    std::vector<int> buffer(n);
 
-    while (!isSorted) {
-        isSorted = true;
+#pragma omp parallel
+    {
+        int threads = omp_get_num_threads();
+        int id = omp_get_thread_num();
+        size_t begin = blockBorder(n, threads, id);
+        size_t end = blockBorder(n, threads, id + 1);
 
-        // Нечетная фаза (нечетные индексы)
-#pragma omp parallel for shared(arr, isSorted)
-        for (int i = 1; i <= n - 2; i += 2) {
-            if (arr[i] > arr[i + 1]) {
-#pragma omp critical
-                {
-                    std::swap(arr[i], arr[i + 1]);
-                    isSorted = false;
+        // Указатели у каждого потока свои, но меняются одинаково во всех потоках
+        int* source = arr.data();
+        int* target = buffer.data();
+
+        std::sort(source + begin, source + end);
+#pragma omp barrier
+
+        for (int phase = 0; phase < threads; ++phase) {
+            // Соседний блок, с которым поток образует пару в этой фазе
+            int partner = ((id + phase) % 2 == 0) ? id + 1 : id - 1;
+            bool paired = partner >= 0 && partner < threads && begin < end;
+
+            if (paired && id < partner) {
+                size_t otherEnd = blockBorder(n, threads, partner + 1);
+                if (end == otherEnd || source[end - 1] <= source[end]) {
+                    // Блоки уже упорядочены друг относительно друга
+                    std::copy(source + begin, source + end, target + begin);
+                }
+                else {
+                    // Меньшие элементы двух блоков: слияние с начала
+                    const int* left = source + begin;
+                    const int* right = source + end;
+                    const int* rightEnd = source + otherEnd;
+                    for (size_t k = begin; k < end; ++k) {
+                        target[k] = (right == rightEnd || *left <= *right) ? *left++ : *right++;
+                    }
+                }
+            }
+            else if (paired) {
+                size_t otherBegin = blockBorder(n, threads, partner);
+                if (otherBegin == begin || source[begin - 1] <= source[begin]) {
+                    std::copy(source + begin, source + end, target + begin);
+                }
+                else {
+                    // Большие элементы двух блоков: слияние с конца
+                    const int* left = source + begin;
+                    const int* right = source + end;
+                    const int* leftBegin = source + otherBegin;
+                    for (size_t k = end; k > begin; --k) {
+                        target[k - 1] = (left == leftBegin || *(right - 1) >= *(left - 1)) ? *--right : *--left;
+                    }
                 }
             }
+            else {
+                std::copy(source + begin, source + end, target + begin);
+            }
+
+            std::swap(source, target);
+#pragma omp barrier
         }
 
-        // Четная фаза (четные индексы)
-#pragma omp parallel for shared(arr, isSorted)
-        for (int i = 0; i <= n - 2; i += 2) {
-            if (arr[i] > arr[i + 1]) {
-#pragma omp critical
-                {
-                    std::swap(arr[i], arr[i + 1]);
-                    isSorted = false;
+        // После нечетного числа фаз результат лежит во вспомогательном буфере
+        if (source != arr.data()) {
+            std::copy(source + begin, source + end, arr.data() + begin);
+        }
+    }
+}
+
+// Запись, сортируемая по ключу; index хранит исходную позицию для проверки устойчивости
+struct Record {
+    int key;
+    int index;
+};
+
+// Сортировка вставками для маленьких частей
+template <typename RandomIt, typename Compare>
+void insertionSort(RandomIt first, RandomIt last, Compare comp) {
+    if (first == last) return;
+    for (RandomIt i = first + 1; i != last; ++i) {
+        auto value = std::move(*i);
+        RandomIt j = i;
+        for (; j != first && comp(value, *(j - 1)); --j) {
+            *j = std::move(*(j - 1));
+        }
+        *j = std::move(value);
+    }
+}
+
+/*
+ * Параллельное слияние [first1, last1) и [first2, last2) в out с перемещением элементов.
+ * Средний элемент большего диапазона делит оба диапазона (бинарным поиском во втором),
+ * и две независимые половины сливаются отдельными задачами OpenMP.
+ * При равных элементах первым идет элемент первого диапазона, поэтому слияние устойчиво.
+ */
+template <typename It1, typename It2, typename OutIt, typename Compare>
+void parallelMerge(It1 first1, It1 last1, It2 first2, It2 last2, OutIt out, Compare comp) {
+    ptrdiff_t size1 = last1 - first1;
+    ptrdiff_t size2 = last2 - first2;
+    if (size1 + size2 <= MERGE_SORT_TASK_SIZE) {
+        std::merge(std::make_move_iterator(first1), std::make_move_iterator(last1),
+            std::make_move_iterator(first2), std::make_move_iterator(last2), out, comp);
+        return;
+    }
+
+    It1 middle1;
+    It2 middle2;
+    if (size1 >= size2) {
+        middle1 = first1 + size1 / 2;
+        middle2 = std::lower_bound(first2, last2, *middle1, comp);
+    }
+    else {
+        middle2 = first2 + size2 / 2;
+        middle1 = std::upper_bound(first1, last1, *middle2, comp);
+    }
+    OutIt outMiddle = out + (middle1 - first1) + (middle2 - first2);
+
+#pragma omp task
+    parallelMerge(first1, middle1, first2, middle2, out, comp);
+    parallelMerge(middle1, last1, middle2, last2, outMiddle, comp);
+#pragma omp taskwait
+}
+
+/*
+ * Рекурсивная сортировка слиянием [first, last) с буфером buffer того же размера.
+ * Половины сортируются в противоположное место (массив или буфер), после чего
+ * сливаются туда, где должен оказаться результат: в буфер при toBuffer, иначе в массив.
+ * Так каждый уровень выполняет одно перемещение данных.
+ */
+template <typename RandomIt, typename BufferIt, typename Compare>
+void mergeSortRecursive(RandomIt first, RandomIt last, BufferIt buffer, bool toBuffer, Compare comp) {
+    ptrdiff_t size = last - first;
+    if (size <= MERGE_SORT_INSERTION_SIZE) {
+        insertionSort(first, last, comp);
+        if (toBuffer) {
+            std::move(first, last, buffer);
+        }
+        return;
+    }
+
+    ptrdiff_t half = size / 2;
+    if (size > MERGE_SORT_TASK_SIZE) {
+#pragma omp task
+        mergeSortRecursive(first, first + half, buffer, !toBuffer, comp);
+        mergeSortRecursive(first + half, last, buffer + half, !toBuffer, comp);
+#pragma omp taskwait
+    }
+    else {
+        mergeSortRecursive(first, first + half, buffer, !toBuffer, comp);
+        mergeSortRecursive(first + half, last, buffer + half, !toBuffer, comp);
+    }
+
+    if (toBuffer) {
+        parallelMerge(first, first + half, first + half, last, buffer, comp);
+    }
+    else {
+        parallelMerge(buffer, buffer + half, buffer + half, buffer + size, first, comp);
+    }
+}
+
+/*
+ * Параллельная устойчивая сортировка слиянием для произвольного итератора
+ * произвольного доступа и компаратора. Вспомогательный буфер scratch
+ * увеличивается до размера диапазона и может переиспользоваться между вызовами.
+ * Внутри уже открытой параллельной области задачи создаются в текущей команде потоков.
+ */
+template <typename RandomIt, typename Compare>
+void parallelMergeSort(RandomIt first, RandomIt last, Compare comp,
+    std::vector<typename std::iterator_traits<RandomIt>::value_type>& scratch) {
+    ptrdiff_t size = last - first;
+    if (size < 2) return;
+    if (scratch.size() < static_cast<size_t>(size)) {
+        scratch.resize(size);
+    }
+
+    if (omp_in_parallel()) {
+        mergeSortRecursive(first, last, scratch.begin(), false, comp);
+        return;
+    }
+
+#pragma omp parallel
+#pragma omp single
+    mergeSortRecursive(first, last, scratch.begin(), false, comp);
+}
+
+template <typename RandomIt, typename Compare>
+void parallelMergeSort(RandomIt first, RandomIt last, Compare comp) {
+    std::vector<typename std::iterator_traits<RandomIt>::value_type> scratch;
+    parallelMergeSort(first, last, comp, scratch);
+}
+
+template <typename RandomIt>
+void parallelMergeSort(RandomIt first, RandomIt last) {
+    parallelMergeSort(first, last, std::less<typename std::iterator_traits<RandomIt>::value_type>());
+}
+
+// Минимум и максимум массива: частичные значения потоков объединяются после цикла
+std::pair<int, int> minMaxParallel(const std::vector<int>& arr) {
+    size_t n = arr.size();
+    std::vector<std::pair<int, int>> partial(omp_get_max_threads(), std::make_pair(arr[0], arr[0]));
+
+#pragma omp parallel
+    {
+        int threads = omp_get_num_threads();
+        int id = omp_get_thread_num();
+        int minValue = arr[0];
+        int maxValue = arr[0];
+        for (size_t i = blockBorder(n, threads, id); i < blockBorder(n, threads, id + 1); ++i) {
+            minValue = std::min(minValue, arr[i]);
+            maxValue = std::max(maxValue, arr[i]);
+        }
+        partial[id] = std::make_pair(minValue, maxValue);
+    }
+
+    std::pair<int, int> result = partial[0];
+    for (const auto& p : partial) {
+        result.first = std::min(result.first, p.first);
+        result.second = std::max(result.second, p.second);
+    }
+    return result;
+}
+
+/*
+ * Сортировка подсчетом для ключей из диапазона [minValue, minValue + range).
+ * Каждый поток строит гистограмму своего блока, затем потоки суммируют
+ * гистограммы по своим частям диапазона и заполняют массив значениями
+ * по вычисленным смещениям. Данные читаются один раз.
+ */
+void countingSortParallel(std::vector<int>& arr, int minValue, size_t range) {
+    size_t n = arr.size();
+    uint32_t base = static_cast<uint32_t>(minValue);
+    std::vector<size_t> histogram(omp_get_max_threads() * range);
+    std::vector<size_t> total(range);
+    std::vector<size_t> offset(range);
+
+#pragma omp parallel
+    {
+        int threads = omp_get_num_threads();
+        int id = omp_get_thread_num();
+        size_t* counts = &histogram[id * range];
+
+        for (size_t i = blockBorder(n, threads, id); i < blockBorder(n, threads, id + 1); ++i) {
+            counts[static_cast<uint32_t>(arr[i]) - base]++;
+        }
+#pragma omp barrier
+
+        size_t valueBegin = blockBorder(range, threads, id);
+        size_t valueEnd = blockBorder(range, threads, id + 1);
+        for (size_t v = valueBegin; v < valueEnd; ++v) {
+            size_t sum = 0;
+            for (int t = 0; t < threads; ++t) {
+                sum += histogram[t * range + v];
+            }
+            total[v] = sum;
+        }
+#pragma omp barrier
+
+#pragma omp single
+        {
+            size_t sum = 0;
+            for (size_t v = 0; v < range; ++v) {
+                offset[v] = sum;
+                sum += total[v];
+            }
+        }
+
+        for (size_t v = valueBegin; v < valueEnd; ++v) {
+            std::fill(arr.data() + offset[v], arr.data() + offset[v] + total[v], static_cast<int>(base + static_cast<uint32_t>(v)));
+        }
+    }
+}
+
+/*
+ * Поразрядная сортировка LSD по RADIX_BITS бит за проход.
+ * Ключом служит разность value - minValue, поэтому отрицательные числа
+ * обрабатываются без преобразований, а число проходов определяется
+ * фактическим диапазоном значений.
+ * Каждый проход выполняется в общей параллельной области:
+ *  1) поток строит гистограмму разрядов своего блока;
+ *  2) префиксные суммы по потокам считаются параллельно (каждый поток берет
+ *     свою часть корзин), затем суммы корзин сканируются одним потоком;
+ *  3) поток раскладывает свой блок, накапливая элементы каждой корзины
+ *     в буфере размером со строку кэша и сбрасывая его целиком, чтобы
+ *     запись в 256 разных мест массива не вытесняла кэш.
+ */
+void radixSortLSD(std::vector<int>& arr, int minValue, int passes) {
+    size_t n = arr.size();
+    uint32_t base = static_cast<uint32_t>(minValue);
+    std::vector<int> buffer(n);
+    // Гистограмма потока t занимает histogram[t * RADIX_BUCKETS ... (t + 1) * RADIX_BUCKETS)
+    std::vector<size_t> histogram(omp_get_max_threads() * RADIX_BUCKETS);
+    std::vector<size_t> bucketTotal(RADIX_BUCKETS);
+
+#pragma omp parallel
+    {
+        int threads = omp_get_num_threads();
+        int id = omp_get_thread_num();
+        size_t begin = blockBorder(n, threads, id);
+        size_t end = blockBorder(n, threads, id + 1);
+        int bucketBegin = static_cast<int>(blockBorder(RADIX_BUCKETS, threads, id));
+        int bucketEnd = static_cast<int>(blockBorder(RADIX_BUCKETS, threads, id + 1));
+        size_t* counts = &histogram[id * RADIX_BUCKETS];
+
+        std::vector<int> combine(RADIX_BUCKETS * RADIX_BUFFER_SIZE);
+        int filled[RADIX_BUCKETS];
+
+        int* source = arr.data();
+        int* target = buffer.data();
+
+        for (int pass = 0; pass < passes; ++pass) {
+            int shift = pass * RADIX_BITS;
+
+            std::fill(counts, counts + RADIX_BUCKETS, 0);
+            for (size_t i = begin; i < end; ++i) {
+                counts[((static_cast<uint32_t>(source[i]) - base) >> shift) & (RADIX_BUCKETS - 1)]++;
+            }
+#pragma omp barrier
+
+            // Смещение потока внутри корзины и размер корзины
+            for (int d = bucketBegin; d < bucketEnd; ++d) {
+                size_t sum = 0;
+                for (int t = 0; t < threads; ++t) {
+                    size_t count = histogram[t * RADIX_BUCKETS + d];
+                    histogram[t * RADIX_BUCKETS + d] = sum;
+                    sum += count;
                 }
+                bucketTotal[d] = sum;
             }
+#pragma omp barrier
+
+#pragma omp single
+            {
+                size_t sum = 0;
+                for (int d = 0; d < RADIX_BUCKETS; ++d) {
+                    size_t count = bucketTotal[d];
+                    bucketTotal[d] = sum;
+                    sum += count;
+                }
+            }
+
+            for (int d = 0; d < RADIX_BUCKETS; ++d) {
+                counts[d] += bucketTotal[d];
+                filled[d] = 0;
+            }
+
+            for (size_t i = begin; i < end; ++i) {
+                int value = source[i];
+                int d = ((static_cast<uint32_t>(value) - base) >> shift) & (RADIX_BUCKETS - 1);
+                int* line = &combine[d * RADIX_BUFFER_SIZE];
+                line[filled[d]++] = value;
+                if (filled[d] == RADIX_BUFFER_SIZE) {
+                    std::memcpy(target + counts[d], line, RADIX_BUFFER_SIZE * sizeof(int));
+                    counts[d] += RADIX_BUFFER_SIZE;
+                    filled[d] = 0;
+                }
+            }
+            for (int d = 0; d < RADIX_BUCKETS; ++d) {
+                std::memcpy(target + counts[d], &combine[d * RADIX_BUFFER_SIZE], filled[d] * sizeof(int));
+            }
+
+            std::swap(source, target);
+#pragma omp barrier
+        }
+
+        if (source != arr.data()) {
+            std::copy(source + begin, source + end, arr.data() + begin);
         }
     }
 }
 
-// Генерация случайного массива
-std::vector<int> generateRandomArray(int size) {
-    std::vector<int> arr(size);
-    for (int i = 0; i < size; ++i) {
-        arr[i] = rand() % 10000;
+// Параллельная сортировка целых чисел: подсчетом при малом диапазоне, иначе поразрядная
+void radixSortParallel(std::vector<int>& arr) {
+    size_t n = arr.size();
+    if (n < RADIX_MIN_SIZE) {
+        std::sort(arr.begin(), arr.end());
+        return;
+    }
+
+    std::pair<int, int> bounds = minMaxParallel(arr);
+    uint32_t span = static_cast<uint32_t>(bounds.second) - static_cast<uint32_t>(bounds.first);
+    if (span == 0) return;
+
+    if (span < COUNTING_SORT_MAX_RANGE && span < n) {
+        countingSortParallel(arr, bounds.first, static_cast<size_t>(span) + 1);
+        return;
+    }
+
+    int bits = 0;
+    while (bits < 32 && (span >> bits) != 0) {
+        ++bits;
+    }
+    radixSortLSD(arr, bounds.first, (bits + RADIX_BITS - 1) / RADIX_BITS);
+}
+
+// Чтение до count чисел из файла; возвращается число прочитанных
+size_t readBlock(std::ifstream& file, int* data, size_t count) {
+    file.read(reinterpret_cast<char*>(data), static_cast<std::streamsize>(count * sizeof(int)));
+    return static_cast<size_t>(file.gcount()) / sizeof(int);
+}
+
+void writeBlock(std::ofstream& file, const int* data, size_t count) {
+    file.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(count * sizeof(int)));
+    if (!file) {
+        throw std::runtime_error("Ошибка записи файла");
+    }
+}
+
+/*
+ * Последовательное чтение серии с двойной буферизацией: пока слияние
+ * использует текущий блок, следующий блок читается асинхронно.
+ */
+class RunReader {
+public:
+    RunReader(const std::string& path, size_t blockSize)
+        : file(path, std::ios::binary), current(blockSize), next(blockSize) {
+        if (!file) {
+            throw std::runtime_error("Не удалось открыть файл " + path);
+        }
+        current.resize(readBlock(file, current.data(), blockSize));
+        startRead();
+    }
+
+    // Асинхронное чтение обращается к полям объекта, поэтому он не копируется и не перемещается
+    RunReader(const RunReader&) = delete;
+    RunReader& operator=(const RunReader&) = delete;
+
+    bool empty() const { return position == current.size(); }
+    int front() const { return current[position]; }
+
+    void pop() {
+        if (++position == current.size() && !current.empty()) {
+            size_t count = pending.get();
+            std::swap(current, next);
+            current.resize(count);
+            position = 0;
+            if (count > 0) {
+                startRead();
+            }
+        }
     }
+
+private:
+    void startRead() {
+        next.resize(next.capacity());
+        pending = std::async(std::launch::async, [this] { return readBlock(file, next.data(), next.size()); });
+    }
+
+    std::ifstream file;
+    std::vector<int> current;
+    std::vector<int> next;
+    size_t position = 0;
+    std::future<size_t> pending;
+};
+
+/*
+ * Запись с двойной буферизацией: заполненный блок записывается асинхронно,
+ * а значения продолжают поступать во второй блок.
+ */
+class BlockWriter {
+public:
+    BlockWriter(const std::string& path, size_t blockSize) : file(path, std::ios::binary), blockSize(blockSize) {
+        if (!file) {
+            throw std::runtime_error("Не удалось создать файл " + path);
+        }
+        current.reserve(blockSize);
+        writing.reserve(blockSize);
+    }
+
+    void push(int value) {
+        current.push_back(value);
+        if (current.size() == blockSize) {
+            flush();
+        }
+    }
+
+    void finish() {
+        flush();
+        if (pending.valid()) {
+            pending.get();
+        }
+        file.close();
+    }
+
+private:
+    void flush() {
+        if (pending.valid()) {
+            pending.get();
+        }
+        std::swap(current, writing);
+        current.clear();
+        pending = std::async(std::launch::async, [this] { writeBlock(file, writing.data(), writing.size()); });
+    }
+
+    std::ofstream file;
+    size_t blockSize;
+    std::vector<int> current;
+    std::vector<int> writing;
+    std::future<void> pending;
+};
+
+/*
+ * Дерево проигравших для k-путевого слияния: во внутренних узлах хранятся
+ * номера серий, проигравших сравнение, в tree[0] - победитель (серия с
+ * наименьшим текущим элементом). После извлечения элемента победителя
+ * достаточно одного прохода от листа к корню: log2(k) сравнений.
+ * Исчерпанная серия считается бесконечно большой.
+ */
+class LoserTree {
+public:
+    explicit LoserTree(std::vector<std::unique_ptr<RunReader>>& runs) : runs(runs), tree(runs.size()) {
+        tree[0] = build(1);
+    }
+
+    int winner() const { return tree[0]; }
+
+    // Повторное состязание после изменения текущего элемента серии leaf
+    void replay(int leaf) {
+        int winnerRun = leaf;
+        int k = static_cast<int>(runs.size());
+        for (int node = (leaf + k) / 2; node > 0; node /= 2) {
+            if (less(tree[node], winnerRun)) {
+                std::swap(tree[node], winnerRun);
+            }
+        }
+        tree[0] = winnerRun;
+    }
+
+private:
+    bool less(int a, int b) const {
+        if (runs[a]->empty()) return false;
+        if (runs[b]->empty()) return true;
+        return runs[a]->front() < runs[b]->front() || (runs[a]->front() == runs[b]->front() && a < b);
+    }
+
+    // Победитель поддерева с корнем node (листья имеют номера k ... 2k - 1)
+    int build(int node) {
+        int k = static_cast<int>(runs.size());
+        if (node >= k) return node - k;
+        int left = build(2 * node);
+        int right = build(2 * node + 1);
+        if (less(left, right)) {
+            tree[node] = right;
+            return left;
+        }
+        tree[node] = left;
+        return right;
+    }
+
+    std::vector<std::unique_ptr<RunReader>>& runs;
+    std::vector<int> tree;
+};
+
+// Слияние отсортированных серий в файл outputPath деревом проигравших
+void mergeRuns(const std::vector<std::string>& runPaths, const std::string& outputPath, size_t blockSize) {
+    std::vector<std::unique_ptr<RunReader>> runs;
+    for (const std::string& path : runPaths) {
+        runs.emplace_back(new RunReader(path, blockSize));
+    }
+
+    BlockWriter output(outputPath, blockSize);
+    if (!runs.empty()) {
+        LoserTree tree(runs);
+        for (int run = tree.winner(); !runs[run]->empty(); run = tree.winner()) {
+            output.push(runs[run]->front());
+            runs[run]->pop();
+            tree.replay(run);
+        }
+    }
+    output.finish();
+}
+
+/*
+ * Внешняя сортировка двоичного файла чисел int, не помещающегося в память.
+ * 1) Файл читается сериями по runSize элементов. Пока серия сортируется
+ *    параллельно (radixSortParallel), следующая читается, а предыдущая
+ *    записывается во временный файл асинхронно.
+ * 2) Серии сливаются деревом проигравших. Чтение каждой серии и запись
+ *    результата идут блоками с двойной буферизацией, так что ввод-вывод
+ *    перекрывается со слиянием. Размер блока выбирается так, чтобы все
+ *    буферы занимали примерно runSize элементов. Если серий больше
+ *    EXTERNAL_MAX_FAN_IN, они сливаются группами в несколько проходов.
+ * Временные файлы outputPath.* удаляются. Возвращается число элементов.
+ */
+size_t externalSort(const std::string& inputPath, const std::string& outputPath, size_t runSize = EXTERNAL_RUN_SIZE) {
+    std::ifstream input(inputPath, std::ios::binary);
+    if (!input) {
+        throw std::runtime_error("Не удалось открыть файл " + inputPath);
+    }
+
+    std::vector<std::string> runPaths;
+    size_t total = 0;
+
+    auto readRun = [&input, runSize] {
+        std::vector<int> run(runSize);
+        run.resize(readBlock(input, run.data(), runSize));
+        return run;
+    };
+
+    std::vector<int> current = readRun();
+    std::future<void> pendingWrite;
+    while (!current.empty()) {
+        std::future<std::vector<int>> nextRead = std::async(std::launch::async, readRun);
+        radixSortParallel(current);
+        total += current.size();
+
+        if (pendingWrite.valid()) {
+            pendingWrite.get();
+        }
+        runPaths.push_back(outputPath + ".run" + std::to_string(runPaths.size()));
+        pendingWrite = std::async(std::launch::async, [runPath = runPaths.back(), sorted = std::move(current)] {
+            std::ofstream run(runPath, std::ios::binary);
+            writeBlock(run, sorted.data(), sorted.size());
+        });
+
+        current = nextRead.get();
+    }
+    if (pendingWrite.valid()) {
+        pendingWrite.get();
+    }
+
+    // Буферы: по два блока на серию и два блока на результат
+    auto blockSize = [runSize](size_t runsCount) {
+        return std::max(EXTERNAL_MIN_BLOCK_SIZE, runSize / (2 * (runsCount + 1)));
+    };
+
+    for (int pass = 0; runPaths.size() > EXTERNAL_MAX_FAN_IN; ++pass) {
+        std::vector<std::string> merged;
+        for (size_t first = 0; first < runPaths.size(); first += EXTERNAL_MAX_FAN_IN) {
+            std::vector<std::string> group(runPaths.begin() + first,
+                runPaths.begin() + std::min(first + EXTERNAL_MAX_FAN_IN, runPaths.size()));
+            merged.push_back(outputPath + ".pass" + std::to_string(pass) + ".run" + std::to_string(merged.size()));
+            mergeRuns(group, merged.back(), blockSize(group.size()));
+            for (const std::string& path : group) {
+                std::remove(path.c_str());
+            }
+        }
+        runPaths = std::move(merged);
+    }
+
+    mergeRuns(runPaths, outputPath, blockSize(runPaths.size()));
+    for (const std::string& path : runPaths) {
+        std::remove(path.c_str());
+    }
+    return total;
+}
+
+// Генерация случайного массива (значения 0..9999, заполняется параллельно)
+std::vector<int> generateRandomArray(int size, uint64_t seed = RANDOM_SEED) {
+    std::vector<int> arr(size);
+    parallel_fill_int(arr.data(), arr.size(), 0, 9999, seed);
+    return arr;
+}
+
+// Случайный массив со значениями во всем диапазоне int
+std::vector<int> generateWideRandomArray(int size, uint64_t seed = RANDOM_SEED) {
+    std::vector<int> arr(size);
+    parallel_fill_int(arr.data(), arr.size(), INT32_MIN, INT32_MAX, seed);
     return arr;
 }
 
@@ -83,11 +766,185 @@ bool isSorted(const std::vector<int>& arr) {
     return true;
 }
 
+// Время сортировки массива в секундах
+template <typename Sort>
+double measureSort(std::vector<int>& arr, Sort sort) {
+    auto start = std::chrono::high_resolution_clock::now();
+    sort(arr);
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+// Сравнение поразрядной сортировки с std::sort и четно-нечетной сортировкой (10^4 ... 10^9 элементов)
+void benchmarkSorts() {
+    std::cout << std::endl << "Сравнение сортировок, потоков: " << omp_get_max_threads() << std::endl;
+
+    for (int wide = 0; wide < 2; ++wide) {
+        std::cout << (wide ? "Ключи во всем диапазоне int (поразрядная сортировка):"
+            : "Ключи 0..9999 (сортировка подсчетом):") << std::endl;
+
+        for (long long size = 10000; size <= 1000000000LL; size *= 10) {
+            try {
+                std::vector<int> arr = wide ? generateWideRandomArray(static_cast<int>(size))
+                    : generateRandomArray(static_cast<int>(size));
+                std::vector<int> reference = arr;
+
+                std::cout << std::setw(10) << size << ": " << std::fixed << std::setprecision(4);
+                if (size <= static_cast<long long>(ODD_EVEN_BENCHMARK_MAX_SIZE)) {
+                    std::vector<int> copy = arr;
+                    std::cout << "Odd-Even " << measureSort(copy, oddEvenSortSequential) << " сек, ";
+                }
+
+                double stdTime = measureSort(reference, [](std::vector<int>& a) { std::sort(a.begin(), a.end()); });
+                double radixTime = measureSort(arr, radixSortParallel);
+                bool correct = arr == reference;
+
+                std::cout << "std::sort " << stdTime << " сек, поразрядная " << radixTime << " сек ("
+                    << std::setprecision(1) << size / radixTime / 1e6 << " млн эл./сек), ускорение "
+                    << std::setprecision(2) << stdTime / radixTime << "x, "
+                    << (correct ? "корректно" : "некорректно") << std::endl;
+            }
+            catch (const std::bad_alloc&) {
+                std::cout << std::endl << "Недостаточно памяти для " << size << " элементов" << std::endl;
+                break;
+            }
+        }
+    }
+}
+
+// Масштабируемость сортировки слиянием по числу потоков и сортировка записей по компаратору
+void benchmarkMergeSort() {
+    const int maxThreads = omp_get_max_threads();
+    std::cout << std::endl << "Параллельная сортировка слиянием, " << MERGE_SORT_BENCHMARK_SIZE << " элементов:" << std::endl;
+
+    std::vector<int> source = generateWideRandomArray(MERGE_SORT_BENCHMARK_SIZE);
+    std::vector<int> reference = source;
+    double stdTime = measureSort(reference, [](std::vector<int>& a) { std::sort(a.begin(), a.end()); });
+    std::cout << "std::sort: " << std::fixed << std::setprecision(4) << stdTime << " сек" << std::endl;
+
+    std::vector<int> threadCounts;
+    for (int threads = 1; threads < maxThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+
+    // Один буфер на все запуски
+    std::vector<int> scratch;
+    double singleThreadTime = 0.0;
+    for (int threads : threadCounts) {
+        std::vector<int> arr = source;
+        omp_set_num_threads(threads);
+        double time = measureSort(arr, [&scratch](std::vector<int>& a) {
+            parallelMergeSort(a.begin(), a.end(), std::less<int>(), scratch);
+        });
+        if (threads == 1) {
+            singleThreadTime = time;
+        }
+
+        std::cout << "Потоков " << std::setw(3) << threads << ": " << std::setprecision(4) << time << " сек, "
+            << std::setprecision(1) << MERGE_SORT_BENCHMARK_SIZE / time / 1e6 << " млн эл./сек, ускорение "
+            << std::setprecision(2) << singleThreadTime / time << "x, "
+            << (arr == reference ? "корректно" : "некорректно") << std::endl;
+    }
+    omp_set_num_threads(maxThreads);
+
+    // Записи по убыванию ключа: результат должен совпасть с std::stable_sort
+    std::vector<Record> records(RECORD_BENCHMARK_SIZE);
+    const CounterRng rng(RANDOM_SEED);
+#pragma omp parallel for schedule(static)
+    for (int i = 0; i < RECORD_BENCHMARK_SIZE; ++i) {
+        records[i].key = static_cast<int>(CounterRng::to_range(rng.bits32(i), 0, 999));
+        records[i].index = i;
+    }
+    std::vector<Record> stableRecords = records;
+    auto byKeyDescending = [](const Record& a, const Record& b) { return a.key > b.key; };
+
+    auto start = std::chrono::high_resolution_clock::now();
+    std::stable_sort(stableRecords.begin(), stableRecords.end(), byKeyDescending);
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> stableTime = end - start;
+
+    start = std::chrono::high_resolution_clock::now();
+    parallelMergeSort(records.begin(), records.end(), byKeyDescending);
+    end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> recordsTime = end - start;
+
+    bool stable = std::equal(records.begin(), records.end(), stableRecords.begin(),
+        [](const Record& a, const Record& b) { return a.key == b.key && a.index == b.index; });
+
+    std::cout << "Записи (" << RECORD_BENCHMARK_SIZE << ", по убыванию ключа): std::stable_sort "
+        << std::setprecision(4) << stableTime.count() << " сек, параллельная " << recordsTime.count() << " сек, "
+        << (stable ? "результаты совпадают" : "результаты не совпадают") << std::endl;
+}
+
+// Внешняя сортировка временного файла в текущем каталоге с проверкой результата
+void testExternalSort() {
+    const std::string inputPath = "lab5_external_input.bin";
+    const std::string outputPath = "lab5_external_output.bin";
+    const size_t blockSize = size_t(1) << 20;
+
+    std::cout << std::endl << "Внешняя сортировка файла из " << EXTERNAL_TEST_SIZE << " чисел, серии по "
+        << EXTERNAL_TEST_RUN_SIZE << " чисел:" << std::endl;
+
+    try {
+        // Контрольная сумма по модулю 2^64 не зависит от порядка элементов
+        unsigned long long inputChecksum = 0;
+        {
+            std::ofstream input(inputPath, std::ios::binary);
+            std::vector<int> block(blockSize);
+            for (size_t written = 0; written < EXTERNAL_TEST_SIZE; written += block.size()) {
+                // Блок с номерами элементов written...: файл совпадает с generateWideRandomArray(EXTERNAL_TEST_SIZE)
+                block.resize(std::min(blockSize, EXTERNAL_TEST_SIZE - written));
+                parallel_fill_int(block.data(), block.size(), INT32_MIN, INT32_MAX, RANDOM_SEED, written);
+                for (int value : block) {
+                    inputChecksum += static_cast<unsigned int>(value);
+                }
+                writeBlock(input, block.data(), block.size());
+            }
+        }
+
+        auto start = std::chrono::high_resolution_clock::now();
+        size_t sortedCount = externalSort(inputPath, outputPath, EXTERNAL_TEST_RUN_SIZE);
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> sortTime = end - start;
+
+        // Результат читается блоками: порядок проверяется и на границах блоков
+        std::ifstream output(outputPath, std::ios::binary);
+        std::vector<int> block(blockSize);
+        unsigned long long outputChecksum = 0;
+        size_t outputCount = 0;
+        bool ordered = true;
+        int previous = INT32_MIN;
+        for (size_t count = readBlock(output, block.data(), blockSize); count > 0; count = readBlock(output, block.data(), blockSize)) {
+            for (size_t i = 0; i < count; ++i) {
+                ordered = ordered && previous <= block[i];
+                previous = block[i];
+                outputChecksum += static_cast<unsigned int>(block[i]);
+            }
+            outputCount += count;
+        }
+
+        bool correct = ordered && sortedCount == EXTERNAL_TEST_SIZE && outputCount == EXTERNAL_TEST_SIZE
+            && outputChecksum == inputChecksum;
+        double megabytes = EXTERNAL_TEST_SIZE * sizeof(int) / (1024.0 * 1024.0);
+        std::cout << "Время: " << std::fixed << std::setprecision(4) << sortTime.count() << " сек, "
+            << std::setprecision(1) << megabytes / sortTime.count() << " МБ/сек, "
+            << (correct ? "корректно" : "некорректно") << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cout << "Ошибка внешней сортировки: " << e.what() << std::endl;
+    }
+
+    std::remove(inputPath.c_str());
+    std::remove(outputPath.c_str());
+}
+
 int main() {
     // Для корректного отображения русского языка в консоли Windows
     setlocale(LC_ALL, "Russian");
 
     const int arraySize = 10000;
+    const int largeArraySize = 100000000;
     std::vector<int> arrSequential = generateRandomArray(arraySize);
     std::vector<int> arrParallel = arrSequential;
 
@@ -114,5 +971,31 @@ int main() {
         << (parallelCorrect ? "корректно" : "некорректно") << std::endl;
     std::cout << "Ускорение: " << sequentialTime.count() / parallelTime.count() << "x" << std::endl;
 
+    // Блочная версия на большом массиве сравнивается с std::sort
+    std::vector<int> arrLarge = generateRandomArray(largeArraySize);
+    std::vector<int> arrReference = arrLarge;
+
+    start = std::chrono::high_resolution_clock::now();
+    std::sort(arrReference.begin(), arrReference.end());
+    end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> referenceTime = end - start;
+
+    start = std::chrono::high_resolution_clock::now();
+    oddEvenSortParallel(arrLarge);
+    end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> largeTime = end - start;
+
+    bool largeCorrect = isSorted(arrLarge) && arrLarge == arrReference;
+
+    std::cout << std::endl << "Массив из " << largeArraySize << " элементов, потоков: " << omp_get_max_threads() << std::endl;
+    std::cout << "std::sort: " << referenceTime.count() << " секунд" << std::endl;
+    std::cout << "Параллельная версия: " << largeTime.count() << " секунд, "
+        << (largeCorrect ? "корректно" : "некорректно") << std::endl;
+    std::cout << "Ускорение: " << referenceTime.count() / largeTime.count() << "x" << std::endl;
+
+    benchmarkSorts();
+    benchmarkMergeSort();
+    testExternalSort();
+
     return 0;
 }
@@ -1,55 +1,644 @@
 #include <iostream>
 #include <vector>
-#include <random>
 #include <chrono>
+#include <iomanip>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
 #include <omp.h>
 #include <windows.h>
+#include "../common/cpu_features.h"
+#include "../common/packed_array.h"
+#include "../common/counter_rng.h"
+#include "../common/numa.h"
+#include "../common/parallel_algorithms.h"
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
-// Функция для генерации массива случайных чисел
-std::vector<int> generate_random_array(size_t size, int min_val, int max_val) {
-    std::vector<int> array(size);
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<int> dist(min_val, max_val);
+// Число элементов int, обрабатываемых ядром суммы за одну итерацию AVX2 (4 аккумулятора по 4 long long)
+const size_t SUM_AVX2_STEP = 16;
+// Число элементов int за одну итерацию SSE2 (4 аккумулятора по 2 long long)
+const size_t SUM_SSE2_STEP = 8;
+// Число повторов замера, берется лучшее время
+const int SUM_REPEATS = 5;
+// Окно отображения файла в память (256 МБ)
+const size_t MMAP_WINDOW_SIZE = size_t(1) << 28;
+// Блок редукции: сумма, минимум и максимум считаются по блоку, пока он в кэше
+const size_t REDUCE_BLOCK_SIZE = 4096;
 
-    for (size_t i = 0; i < size; ++i) {
-        array[i] = dist(gen);
+/*
+ * Функция для генерации массива случайных чисел (параллельно, результат не зависит от числа потоков).
+ * Массив не обнуляется главным потоком: FirstTouchAllocator касается страниц параллельно,
+ * поэтому участок каждого потока sum_parallel лежит на узле NUMA этого потока
+ */
+FirstTouchVector<int> generate_random_array(size_t size, int min_val, int max_val, uint64_t seed = random_seed()) {
+    FirstTouchVector<int> array(size);
+    parallel_fill_int(array.data(), size, min_val, max_val, seed);
+    return array;
+}
+
+/*
+ * Ядра суммы: int расширяются до long long, чтобы сумма не переполнялась.
+ * Несколько независимых аккумуляторов убирают цепочку зависимостей сложений,
+ * поэтому скорость ограничивается чтением памяти, а не задержкой сложения.
+ */
+using SumKernel = long long (*)(const int* data, size_t count);
+
+long long sum_kernel_scalar(const int* data, size_t count) {
+    long long acc0 = 0, acc1 = 0, acc2 = 0, acc3 = 0;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        acc0 += data[i];
+        acc1 += data[i + 1];
+        acc2 += data[i + 2];
+        acc3 += data[i + 3];
+    }
+    for (; i < count; ++i) {
+        acc0 += data[i];
     }
+    return acc0 + acc1 + acc2 + acc3;
+}
 
-    return array;
+#ifdef CPU_X86
+// Сумма двух 64-битных половин регистра
+inline long long horizontal_sum_epi64(__m128i v) {
+    long long parts[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(parts), v);
+    return parts[0] + parts[1];
+}
+
+// В SSE2 нет знакового расширения, поэтому старшие половины берутся из маски знака
+inline void add_widened_sse2(__m128i& acc_lo, __m128i& acc_hi, __m128i v) {
+    __m128i sign = _mm_srai_epi32(v, 31);
+    acc_lo = _mm_add_epi64(acc_lo, _mm_unpacklo_epi32(v, sign));
+    acc_hi = _mm_add_epi64(acc_hi, _mm_unpackhi_epi32(v, sign));
+}
+
+long long sum_kernel_sse2(const int* data, size_t count) {
+    __m128i acc0 = _mm_setzero_si128(), acc1 = _mm_setzero_si128();
+    __m128i acc2 = _mm_setzero_si128(), acc3 = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + SUM_SSE2_STEP <= count; i += SUM_SSE2_STEP) {
+        add_widened_sse2(acc0, acc1, _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)));
+        add_widened_sse2(acc2, acc3, _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 4)));
+    }
+    __m128i acc = _mm_add_epi64(_mm_add_epi64(acc0, acc1), _mm_add_epi64(acc2, acc3));
+    return horizontal_sum_epi64(acc) + sum_kernel_scalar(data + i, count - i);
+}
+
+TARGET_AVX2 long long sum_kernel_avx2(const int* data, size_t count) {
+    __m256i acc0 = _mm256_setzero_si256(), acc1 = _mm256_setzero_si256();
+    __m256i acc2 = _mm256_setzero_si256(), acc3 = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + SUM_AVX2_STEP <= count; i += SUM_AVX2_STEP) {
+        __m256i v0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 8));
+        acc0 = _mm256_add_epi64(acc0, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v0)));
+        acc1 = _mm256_add_epi64(acc1, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v0, 1)));
+        acc2 = _mm256_add_epi64(acc2, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v1)));
+        acc3 = _mm256_add_epi64(acc3, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v1, 1)));
+    }
+    __m256i acc = _mm256_add_epi64(_mm256_add_epi64(acc0, acc1), _mm256_add_epi64(acc2, acc3));
+    __m128i half = _mm_add_epi64(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    return horizontal_sum_epi64(half) + sum_kernel_scalar(data + i, count - i);
+}
+#endif
+
+// Лучшее ядро для текущего процессора (выбирается один раз)
+SumKernel sum_kernel() {
+#ifdef CPU_X86
+    static const SumKernel kernel = cpu_features().avx2 ? sum_kernel_avx2
+        : cpu_features().sse2 ? sum_kernel_sse2 : sum_kernel_scalar;
+#else
+    static const SumKernel kernel = sum_kernel_scalar;
+#endif
+    return kernel;
+}
+
+const char* sum_kernel_name(SumKernel kernel) {
+#ifdef CPU_X86
+    if (kernel == sum_kernel_avx2) return "AVX2";
+    if (kernel == sum_kernel_sse2) return "SSE2";
+#endif
+    return "скалярное";
 }
 
 // Последовательное вычисление суммы
-long long sum(const std::vector<int>& array) {
-    long long total = 0;
-    for (int num : array) {
-        total += num;
+long long sum(const FirstTouchVector<int>& array) {
+    return sum_kernel()(array.data(), array.size());
+}
+
+// Параллельное вычисление суммы: каждый поток обрабатывает свой непрерывный участок ядром SIMD
+long long sum_parallel(const FirstTouchVector<int>& array) {
+    const SumKernel kernel = sum_kernel();
+    const int* data = array.data();
+    // Границы участков кратны 16 элементам (64 байта): потоки не делят строки кэша
+    return parallel_reduce_blocks(array.size(), 0LL,
+        [&](size_t begin, size_t end) { return kernel(data + begin, end - begin); },
+        std::plus<long long>(), SUM_AVX2_STEP);
+}
+
+// Лучшее время из SUM_REPEATS запусков и результат суммы
+template <typename Sum>
+double measure_sum(Sum sum_function, long long& result) {
+    double best = 0.0;
+    for (int repeat = 0; repeat < SUM_REPEATS; ++repeat) {
+        auto start = std::chrono::high_resolution_clock::now();
+        result = sum_function();
+        auto end = std::chrono::high_resolution_clock::now();
+        double time = std::chrono::duration<double>(end - start).count();
+        best = (repeat == 0) ? time : std::min(best, time);
     }
-    return total;
+    return best;
+}
+
+// Сравнение ядер суммы в одном потоке и параллельной суммы по скорости чтения памяти
+void benchmark_kernels(const FirstTouchVector<int>& numbers) {
+    const double gigabytes = numbers.size() * sizeof(int) / 1e9;
+    std::vector<SumKernel> kernels = { sum_kernel_scalar };
+#ifdef CPU_X86
+    if (cpu_features().sse2) kernels.push_back(sum_kernel_sse2);
+    if (cpu_features().avx2) kernels.push_back(sum_kernel_avx2);
+#endif
+
+    std::cout << "\nЯдра суммы (лучшее из " << SUM_REPEATS << " запусков):" << std::endl;
+    long long reference = 0;
+    for (SumKernel kernel : kernels) {
+        long long result = 0;
+        double time = measure_sum([&] { return kernel(numbers.data(), numbers.size()); }, result);
+        if (kernel == sum_kernel_scalar) reference = result;
+        std::cout << sum_kernel_name(kernel) << ", 1 поток: " << std::fixed << std::setprecision(4)
+            << time << " сек, " << std::setprecision(2) << gigabytes / time << " ГБ/с"
+            << (result == reference ? "" : ", сумма не совпадает") << std::endl;
+    }
+
+    long long result = 0;
+    double time = measure_sum([&] { return sum_parallel(numbers); }, result);
+    std::cout << sum_kernel_name(sum_kernel()) << ", потоков " << omp_get_max_threads() << ": "
+        << std::setprecision(4) << time << " сек, " << std::setprecision(2) << gigabytes / time << " ГБ/с"
+        << (result == reference ? "" : ", сумма не совпадает") << std::endl;
 }
 
-// Параллельное вычисление суммы с использованием OpenMP
-long long sum_parallel(const std::vector<int>& array) {
+/*
+ * Скорость чтения массива потоками каждого узла NUMA. Участки потоков - как в
+ * schedule(static), с точностью до выравнивания границ в sum_parallel совпадают
+ * с участками первого касания; доля локальных страниц показывает, сработало ли размещение.
+ */
+void benchmark_numa(const FirstTouchVector<int>& numbers, long long expected_sum) {
+    const SumKernel kernel = sum_kernel();
+    const int* data = numbers.data();
     long long total = 0;
 
-#pragma omp parallel for reduction(+:total)
-    for (int i = 0; i < array.size(); ++i) {
-        total += array[i];
+    std::vector<NodeBandwidth> report = measure_node_bandwidth(data, numbers.size(), sizeof(int), SUM_REPEATS,
+        [&](size_t begin, size_t end) {
+            long long partial = kernel(data + begin, end - begin);
+#pragma omp atomic
+            total += partial;
+        });
+
+    double total_bytes = 0.0;
+    double total_time = 0.0;
+    std::cout << "\nПропускная способность по узлам NUMA (лучшее из " << SUM_REPEATS << " запусков):" << std::endl;
+    for (const NodeBandwidth& node : report) {
+        total_bytes += node.bytes;
+        total_time = std::max(total_time, node.seconds);
+        std::cout << "Узел " << node.node << ": потоков " << node.threads << ", " << std::fixed << std::setprecision(1)
+            << node.bytes / 1e9 << " ГБ, " << std::setprecision(2) << node.bytes / node.seconds / 1e9 << " ГБ/с, ";
+        if (node.checked_pages > 0) {
+            std::cout << "локальных страниц " << std::setprecision(0) << 100.0 * node.local_pages / node.checked_pages << "%" << std::endl;
+        }
+        else {
+            std::cout << "размещение страниц неизвестно" << std::endl;
+        }
+    }
+    // Каждый из SUM_REPEATS запусков добавляет полную сумму массива
+    std::cout << "Всего: " << std::setprecision(2) << total_bytes / total_time / 1e9 << " ГБ/с, сумма "
+        << (total == expected_sum * SUM_REPEATS ? "совпадает" : "не совпадает") << std::endl;
+}
+
+// Параллельная сумма упакованного массива: границы участков кратны 64 элементам
+long long sum_packed_parallel(const PackedArray& array) {
+    return parallel_reduce_blocks(array.size(), 0LL,
+        [&](size_t begin, size_t end) { return array.sum(begin, end); },
+        std::plus<long long>(), 64);
+}
+
+// Время (сек), прошедшее с момента start
+double seconds_since(std::chrono::high_resolution_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+/*
+ * Другие редукции и префиксные суммы на тех же шаблонах, что и sum_parallel:
+ * минимум и максимум, индекс первого максимума, гистограмма значений
+ * min_val..max_val, включающая и исключающая префиксные суммы.
+ * Каждый результат сверяется с последовательным вычислением.
+ */
+void benchmark_parallel_algorithms(const FirstTouchVector<int>& numbers, int min_val, int max_val) {
+    const int* data = numbers.data();
+    const size_t size = numbers.size();
+    const double gigabytes = size * sizeof(int) / 1e9;
+
+    auto print = [](const char* name, double time, double gigabytes, bool correct) {
+        std::cout << name << ": " << std::fixed << std::setprecision(4) << time << " сек, "
+            << std::setprecision(2) << gigabytes / time << " ГБ/с, "
+            << (correct ? "совпадает" : "не совпадает") << std::endl;
+    };
+
+    std::cout << "\nРедукции и префиксные суммы (потоков " << omp_get_max_threads() << "):" << std::endl;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    int min_value = parallel_reduce(numbers, std::numeric_limits<int>::max(), [](int a, int b) { return std::min(a, b); });
+    int max_value = parallel_reduce(numbers, std::numeric_limits<int>::min(), [](int a, int b) { return std::max(a, b); });
+    double time = seconds_since(start);
+    auto bounds = std::minmax_element(numbers.begin(), numbers.end());
+    print("Минимум и максимум", time, 2 * gigabytes, min_value == *bounds.first && max_value == *bounds.second);
+
+    // При равных значениях берется меньший индекс, поэтому находится первое вхождение максимума
+    struct ArgMax {
+        int value;
+        size_t index;
+    };
+    start = std::chrono::high_resolution_clock::now();
+    ArgMax arg_max = parallel_reduce_blocks(size, ArgMax{ std::numeric_limits<int>::min(), size },
+        [&](size_t begin, size_t end) {
+            ArgMax best = { data[begin], begin };
+            for (size_t i = begin + 1; i < end; ++i) {
+                if (data[i] > best.value) best = { data[i], i };
+            }
+            return best;
+        },
+        [](const ArgMax& a, const ArgMax& b) {
+            return (b.value > a.value || (b.value == a.value && b.index < a.index)) ? b : a;
+        });
+    time = seconds_since(start);
+    size_t expected_index = std::max_element(numbers.begin(), numbers.end()) - numbers.begin();
+    print("Индекс максимума", time, gigabytes, arg_max.index == expected_index);
+
+    // Каждый поток строит гистограмму своего участка, гистограммы складываются в порядке потоков
+    const size_t bins = static_cast<size_t>(max_val - min_val) + 1;
+    start = std::chrono::high_resolution_clock::now();
+    std::vector<long long> histogram = parallel_reduce_blocks(size, std::vector<long long>(bins, 0),
+        [&](size_t begin, size_t end) {
+            std::vector<long long> local(bins, 0);
+            for (size_t i = begin; i < end; ++i) {
+                local[data[i] - min_val]++;
+            }
+            return local;
+        },
+        [](std::vector<long long> a, const std::vector<long long>& b) {
+            for (size_t bin = 0; bin < a.size(); ++bin) a[bin] += b[bin];
+            return a;
+        });
+    time = seconds_since(start);
+    std::vector<long long> expected_histogram(bins, 0);
+    for (size_t i = 0; i < size; ++i) {
+        expected_histogram[data[i] - min_val]++;
+    }
+    print("Гистограмма", time, gigabytes, histogram == expected_histogram);
+
+    // Префиксные суммы в long long: читается int, пишется long long
+    FirstTouchVector<long long> prefix(size);
+    const double scan_gigabytes = size * (sizeof(int) + sizeof(long long)) / 1e9;
+
+    start = std::chrono::high_resolution_clock::now();
+    parallel_scan(numbers, prefix, std::plus<long long>());
+    time = seconds_since(start);
+    bool correct = true;
+    long long running = 0;
+    for (size_t i = 0; i < size && correct; ++i) {
+        running += data[i];
+        correct = prefix[i] == running;
     }
+    print("Включающая префиксная сумма", time, scan_gigabytes, correct);
+
+    start = std::chrono::high_resolution_clock::now();
+    parallel_exclusive_scan(numbers, prefix, 0LL, std::plus<long long>());
+    time = seconds_since(start);
+    correct = true;
+    running = 0;
+    for (size_t i = 0; i < size && correct; ++i) {
+        correct = prefix[i] == running;
+        running += data[i];
+    }
+    print("Исключающая префиксная сумма", time, scan_gigabytes, correct);
+}
 
+// Сравнение параллельной суммы массива int32 и того же массива в упакованном виде
+void benchmark_packed(const FirstTouchVector<int>& numbers, int min_val, int max_val) {
+    PackedArray packed(numbers.data(), numbers.size(), min_val, max_val);
+    const double megabyte = 1024.0 * 1024.0;
+    const double int_bytes = numbers.size() * sizeof(int);
+
+    long long reference = 0;
+    long long result = 0;
+    double int_time = measure_sum([&] { return sum_parallel(numbers); }, reference);
+    double packed_time = measure_sum([&] { return sum_packed_parallel(packed); }, result);
+
+    std::cout << "\nУпакованное хранение значений " << min_val << ".." << max_val << " (потоков " << omp_get_max_threads() << "):" << std::endl;
+    std::cout << "int32: " << std::fixed << std::setprecision(1) << int_bytes / megabyte << " МБ, "
+        << std::setprecision(4) << int_time << " сек, " << std::setprecision(2) << int_bytes / 1e9 / int_time << " ГБ/с, "
+        << std::setprecision(1) << numbers.size() / int_time / 1e6 << " млн эл./с" << std::endl;
+    std::cout << "uint" << packed.element_width() * 8 << ": " << std::setprecision(1) << packed.bytes() / megabyte << " МБ, "
+        << std::setprecision(4) << packed_time << " сек, " << std::setprecision(2) << packed.bytes() / 1e9 / packed_time << " ГБ/с, "
+        << std::setprecision(1) << numbers.size() / packed_time / 1e6 << " млн эл./с, суммы "
+        << (result == reference ? "совпадают" : "не совпадают") << std::endl;
+}
+
+/*
+ * Файл, отображаемый в память окнами (только чтение). Одновременно отображено
+ * одно окно, поэтому размер файла может превышать объем памяти: после
+ * unmap страницы окна освобождаются системой.
+ */
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+#ifdef _WIN32
+        // FILE_FLAG_SEQUENTIAL_SCAN - подсказка системе о последовательном чтении
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error("Не удалось открыть файл " + path);
+        }
+        LARGE_INTEGER file_size;
+        GetFileSizeEx(file, &file_size);
+        bytes = static_cast<unsigned long long>(file_size.QuadPart);
+        if (bytes > 0) {
+            mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping == nullptr) {
+                CloseHandle(file);
+                throw std::runtime_error("Не удалось отобразить файл " + path);
+            }
+        }
+#else
+        descriptor = open(path.c_str(), O_RDONLY);
+        if (descriptor < 0) {
+            throw std::runtime_error("Не удалось открыть файл " + path);
+        }
+        struct stat info;
+        fstat(descriptor, &info);
+        bytes = static_cast<unsigned long long>(info.st_size);
+#endif
+    }
+
+    ~MappedFile() {
+        unmap();
+#ifdef _WIN32
+        if (mapping != nullptr) CloseHandle(mapping);
+        CloseHandle(file);
+#else
+        close(descriptor);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    unsigned long long size() const { return bytes; }
+
+    // Размер страницы: границы участков потоков
+    static size_t page_size() {
+#ifdef _WIN32
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return info.dwPageSize;
+#else
+        return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+    }
+
+    // Смещение окна должно быть кратно этой величине
+    static size_t granularity() {
+#ifdef _WIN32
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return info.dwAllocationGranularity;
+#else
+        return page_size();
+#endif
+    }
+
+    // Отображение окна [offset, offset + length); предыдущее окно освобождается
+    const char* map(unsigned long long offset, size_t length) {
+        unmap();
+#ifdef _WIN32
+        view = MapViewOfFile(mapping, FILE_MAP_READ, static_cast<DWORD>(offset >> 32), static_cast<DWORD>(offset & 0xFFFFFFFFull), length);
+        if (view == nullptr) {
+            throw std::runtime_error("Ошибка отображения окна файла");
+        }
+#else
+        view = mmap(nullptr, length, PROT_READ, MAP_SHARED, descriptor, static_cast<off_t>(offset));
+        if (view == MAP_FAILED) {
+            view = nullptr;
+            throw std::runtime_error("Ошибка отображения окна файла");
+        }
+        // Окно читается один раз по порядку: ядро читает страницы с упреждением и быстрее их вытесняет
+        madvise(view, length, MADV_SEQUENTIAL);
+#endif
+        view_length = length;
+        return static_cast<const char*>(view);
+    }
+
+    void unmap() {
+        if (view == nullptr) return;
+#ifdef _WIN32
+        UnmapViewOfFile(view);
+#else
+        munmap(view, view_length);
+#endif
+        view = nullptr;
+    }
+
+private:
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else
+    int descriptor = -1;
+#endif
+    unsigned long long bytes = 0;
+    void* view = nullptr;
+    size_t view_length = 0;
+};
+
+// Сумма, минимум, максимум и количество элементов файла
+template <typename T>
+struct FileStats {
+    using sum_type = typename std::conditional<std::is_floating_point<T>::value, double, long long>::type;
+
+    sum_type sum = 0;
+    T min = std::numeric_limits<T>::max();
+    T max = std::numeric_limits<T>::lowest();
+    unsigned long long count = 0;
+
+    void merge(const FileStats& other) {
+        sum += other.sum;
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+        count += other.count;
+    }
+};
+
+// Сумма блока: для int используется векторное ядро, для остальных типов - простой цикл
+template <typename T>
+typename FileStats<T>::sum_type sum_block(const T* data, size_t count) {
+    typename FileStats<T>::sum_type total = 0;
+    for (size_t i = 0; i < count; ++i) {
+        total += data[i];
+    }
     return total;
 }
 
-int main() {
+inline long long sum_block(const int* data, size_t count) {
+    return sum_kernel()(data, count);
+}
+
+/*
+ * Статистика участка. Участок обрабатывается блоками по REDUCE_BLOCK_SIZE элементов:
+ * минимум и максимум считаются по блоку, пока он еще в кэше после суммирования,
+ * поэтому память читается один раз.
+ */
+template <typename T>
+FileStats<T> reduce_range(const T* data, size_t count) {
+    FileStats<T> stats;
+    for (size_t begin = 0; begin < count; begin += REDUCE_BLOCK_SIZE) {
+        size_t length = std::min(REDUCE_BLOCK_SIZE, count - begin);
+        const T* block = data + begin;
+        stats.sum += sum_block(block, length);
+        auto bounds = std::minmax_element(block, block + length);
+        stats.min = std::min(stats.min, *bounds.first);
+        stats.max = std::max(stats.max, *bounds.second);
+    }
+    stats.count = count;
+    return stats;
+}
+
+/*
+ * Потоковая редукция двоичного файла значений типа T через отображение в память.
+ * Файл просматривается скользящим окном window_size байт; окно делится между
+ * потоками OpenMP на участки, выровненные по границе страницы.
+ * Неполный последний элемент файла игнорируется.
+ */
+template <typename T>
+FileStats<T> reduce_file(const std::string& path, size_t window_size = MMAP_WINDOW_SIZE) {
+    static_assert(std::is_arithmetic<T>::value, "Файл должен содержать числа фиксированного размера");
+
+    MappedFile file(path);
+    const size_t page = MappedFile::page_size();
+    const size_t step = MappedFile::granularity();
+    // Окно кратно гранулярности отображения и размеру элемента
+    window_size = std::max(step, window_size / step * step);
+    const unsigned long long total_bytes = file.size() / sizeof(T) * sizeof(T);
+
+    FileStats<T> result;
+    std::vector<FileStats<T>> partial(omp_get_max_threads());
+    for (unsigned long long offset = 0; offset < total_bytes; offset += window_size) {
+        size_t length = static_cast<size_t>(std::min<unsigned long long>(window_size, total_bytes - offset));
+        const char* view = file.map(offset, length);
+
+#pragma omp parallel
+        {
+            size_t threads = omp_get_num_threads();
+            size_t id = omp_get_thread_num();
+            size_t chunk = ((length + threads - 1) / threads + page - 1) / page * page;
+            size_t begin = std::min(length, id * chunk);
+            size_t end = std::min(length, begin + chunk);
+            partial[id] = reduce_range(reinterpret_cast<const T*>(view + begin), (end - begin) / sizeof(T));
+        }
+
+        for (FileStats<T>& stats : partial) {
+            result.merge(stats);
+            stats = FileStats<T>();
+        }
+    }
+    return result;
+}
+
+// Редукция файла с выводом результата и скорости чтения
+template <typename T>
+FileStats<T> print_file_stats(const std::string& path) {
+    auto start = std::chrono::high_resolution_clock::now();
+    FileStats<T> stats = reduce_file<T>(path);
+    auto end = std::chrono::high_resolution_clock::now();
+    double time = std::chrono::duration<double>(end - start).count();
+
+    std::cout << "Файл " << path << ": элементов " << stats.count << ", сумма " << stats.sum;
+    if (stats.count > 0) {
+        std::cout << ", минимум " << +stats.min << ", максимум " << +stats.max;
+    }
+    std::cout << std::endl << "Время: " << std::fixed << std::setprecision(4) << time << " сек, "
+        << std::setprecision(2) << stats.count * sizeof(T) / 1e9 / time << " ГБ/с" << std::endl;
+    return stats;
+}
+
+// Запись массива в файл и сравнение редукции файла с суммой массива в памяти
+void benchmark_mapped_file(const FirstTouchVector<int>& numbers, long long expected_sum) {
+    const std::string path = "lab6_numbers.bin";
+    std::cout << "\nРедукция файла, отображенного в память (окно " << MMAP_WINDOW_SIZE / (1024 * 1024) << " МБ):" << std::endl;
+    {
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(numbers.data()), numbers.size() * sizeof(int));
+        if (!file) {
+            std::cout << "Не удалось записать файл " << path << std::endl;
+            return;
+        }
+    }
+
+    try {
+        FileStats<int> stats = print_file_stats<int>(path);
+        auto bounds = std::minmax_element(numbers.begin(), numbers.end());
+        bool correct = stats.sum == expected_sum && stats.count == numbers.size()
+            && stats.min == *bounds.first && stats.max == *bounds.second;
+        std::cout << "Результаты " << (correct ? "совпадают" : "не совпадают") << " с массивом в памяти" << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cout << "Ошибка: " << e.what() << std::endl;
+    }
+    std::remove(path.c_str());
+}
+
+int main(int argc, char* argv[]) {
     SetConsoleOutputCP(CP_UTF8);
     setlocale(LC_ALL, "Russian");
+
+    // Lab6 [--pin] [<файл>]: --pin закрепляет потоки OpenMP за процессорами до размещения данных,
+    // <файл> - редукция двоичного файла значений int32 без загрузки в память
+    bool pin = false;
+    std::string file_path;
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "--pin") pin = true;
+        else file_path = argv[i];
+    }
+    if (pin) {
+        std::cout << "Потоков закреплено за процессорами: " << pin_threads() << std::endl;
+    }
+
+    if (!file_path.empty()) {
+        try {
+            print_file_stats<int>(file_path);
+        }
+        catch (const std::exception& e) {
+            std::cout << "Ошибка: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
     // Размер массива можно изменить для тестирования
     const size_t array_size = 100000000;
     const int min_val = 1;
     const int max_val = 100;
 
     std::cout << "Генерация массива из " << array_size << " элементов..." << std::endl;
-    std::vector<int> numbers = generate_random_array(array_size, min_val, max_val);
+    FirstTouchVector<int> numbers = generate_random_array(array_size, min_val, max_val);
 
     // Последовательное вычисление
     std::cout << "Последовательное вычисление суммы..." << std::endl;
@@ -76,5 +665,11 @@ int main() {
     std::cout << "Разница в суммах: " << std::abs(seq_sum - par_sum) << std::endl;
     std::cout << "Ускорение: " << seq_time.count() / par_time.count() << "x" << std::endl;
 
+    benchmark_kernels(numbers);
+    benchmark_numa(numbers, seq_sum);
+    benchmark_packed(numbers, min_val, max_val);
+    benchmark_parallel_algorithms(numbers, min_val, max_val);
+    benchmark_mapped_file(numbers, seq_sum);
+
     return 0;
 }
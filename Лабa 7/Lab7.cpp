@@ -2,6 +2,15 @@
 #include <cmath>
 #include <chrono>
 #include <cassert>
+#include <cstdlib>
+#include <iomanip>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <algorithm>
 #include <omp.h>
 #include <windows.h>
 #include <locale>
@@ -12,6 +21,17 @@
 
 // Константа для точности вычислений
 const double EPS = 1e-8;
+// Допустимая погрешность адаптивного интегрирования по умолчанию
+const double ADAPTIVE_TOLERANCE = 1e-10;
+// Максимальная глубина деления интервала: интервал длиной (b - a) / 2^60 принимается без проверки
+const int ADAPTIVE_MAX_DEPTH = 60;
+// Общий предел числа интервалов (как limit в QUADPACK): после него интервалы больше не делятся
+const long long ADAPTIVE_MAX_INTERVALS = 1 << 17;
+// Центр и полуширина пика во второй тестовой функции
+const double SPIKE_CENTER = 0.3;
+const double SPIKE_WIDTH = 1e-3;
+
+using Integrand = double (*)(double);
 
 // Функция, которую интегрируем (например, гауссовская функция e^(-x^2))
 double func(double x) {
@@ -23,34 +43,254 @@ double analytical_solution(double a, double b) {
     return sqrt(M_PI) / 2 * (erf(b) - erf(a));
 }
 
+// Функция с острым пиком: 1 / ((x - c)^2 + w^2)
+double spike(double x) {
+    double t = x - SPIKE_CENTER;
+    return 1.0 / (t * t + SPIKE_WIDTH * SPIKE_WIDTH);
+}
+
+double spike_solution(double a, double b) {
+    return (atan((b - SPIKE_CENTER) / SPIKE_WIDTH) - atan((a - SPIKE_CENTER) / SPIKE_WIDTH)) / SPIKE_WIDTH;
+}
+
 // Последовательное интегрирование методом средних прямоугольников
-double integrate(double a, double b, int n) {
+double integrate(double a, double b, int n, Integrand f = func) {
     double h = (b - a) / n;
     double sum = 0.0;
 
     for (int i = 0; i < n; ++i) {
         double x = a + (i + 0.5) * h;
-        sum += func(x);
+        sum += f(x);
     }
 
     return sum * h;
 }
 
 // Параллельное интегрирование методом средних прямоугольников с OpenMP
-double integrate_parallel(double a, double b, int n) {
+double integrate_parallel(double a, double b, int n, Integrand f = func) {
     double h = (b - a) / n;
     double sum = 0.0;
 
 #pragma omp parallel for reduction(+:sum)
     for (int i = 0; i < n; ++i) {
         double x = a + (i + 0.5) * h;
-        sum += func(x);
+        sum += f(x);
     }
 
     return sum * h;
 }
 
-int main() {
+// Узлы квадратуры Кронрода на [-1, 1] (неотрицательные, по убыванию); узлы Гаусса - с нечетными номерами и 0
+const double KRONROD_NODES[8] = {
+    0.991455371120812639206854697526329, 0.949107912342758524526189684047851,
+    0.864864423359769072789712788640926, 0.741531185599394439863864773280788,
+    0.586087235467691130294144845693013, 0.405845151377397166906606412076961,
+    0.207784955007898467600689403773245, 0.0
+};
+const double KRONROD_WEIGHTS[8] = {
+    0.022935322010529224963732008058970, 0.063092092629978553290700663189204,
+    0.104790010322250183839876322541518, 0.140653259715525918745189590510238,
+    0.169004726639267902826583426598550, 0.190350578064785409913256402421014,
+    0.204432940075298892414161999234649, 0.209482141084727828012999174891714
+};
+// Веса Гаусса для узлов KRONROD_NODES[1], [3], [5], [7]
+const double GAUSS_WEIGHTS[4] = {
+    0.129484966168869693270611432679082, 0.279705391489276667901467771423780,
+    0.381830050505118944950369775488975, 0.417959183673469387755102040816327
+};
+
+/*
+ * Квадратура Гаусса-Кронрода G7-K15 на [a, b]: 15 вычислений функции,
+ * 7 из них дают оценку Гаусса. Возвращает оценку Кронрода,
+ * в error записывается |K15 - G7| - оценка погрешности сверху
+ */
+double kronrod15(Integrand f, double a, double b, double& error) {
+    const double center = 0.5 * (a + b);
+    const double half = 0.5 * (b - a);
+    const double f_center = f(center);
+    double kronrod = KRONROD_WEIGHTS[7] * f_center;
+    double gauss = GAUSS_WEIGHTS[3] * f_center;
+    for (int j = 0; j < 7; ++j) {
+        const double x = half * KRONROD_NODES[j];
+        const double pair = f(center - x) + f(center + x);
+        kronrod += KRONROD_WEIGHTS[j] * pair;
+        if (j % 2 == 1) gauss += GAUSS_WEIGHTS[j / 2] * pair;
+    }
+    error = fabs((kronrod - gauss) * half);
+    return kronrod * half;
+}
+
+// Интервал, ожидающий вычисления квадратуры
+struct Interval {
+    double a;
+    double b;
+    int depth;
+};
+
+// Принятый интервал: квадратура и оценка погрешности
+struct Piece {
+    double a;
+    double value;
+    double error;
+};
+
+/*
+ * Очередь интервалов одного потока. Владелец кладет и берет интервалы с конца
+ * (последний разделенный интервал, обход в глубину), другие потоки крадут
+ * с начала - самые старые и поэтому самые крупные интервалы.
+ */
+class IntervalDeque {
+public:
+    void push(const Interval& interval) {
+        std::lock_guard<std::mutex> lock(mutex);
+        items.push_back(interval);
+    }
+
+    bool pop(Interval& interval) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (items.empty()) return false;
+        interval = items.back();
+        items.pop_back();
+        return true;
+    }
+
+    bool steal(Interval& interval) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (items.empty()) return false;
+        interval = items.front();
+        items.pop_front();
+        return true;
+    }
+
+private:
+    std::deque<Interval> items;
+    std::mutex mutex;
+};
+
+struct AdaptiveResult {
+    double value = 0.0;
+    double error = 0.0;           // Сумма оценок погрешности принятых интервалов
+    long long evaluations = 0;    // Число вычислений функции
+    size_t intervals = 0;         // Число принятых интервалов
+    long long steals = 0;         // Число интервалов, взятых из чужих очередей
+    bool converged = true;        // false, если допуск не достигнут из-за предела глубины или числа интервалов
+};
+
+/*
+ * Адаптивное интегрирование G7-K15 с очередями интервалов и кражей работы.
+ * Интервал принимается, если оценка погрешности не больше tolerance * (длина / (b - a)),
+ * иначе делится пополам, и обе половины кладутся в очередь потока. Сумма оценок
+ * погрешности принятых интервалов поэтому не больше tolerance. Поток без работы
+ * крадет интервалы у других; работа закончена, когда нет интервалов ни в очередях,
+ * ни в обработке (счетчик pending).
+ * Решение о делении зависит только от самого интервала, а принятые интервалы
+ * суммируются по возрастанию a, поэтому результат не зависит от числа потоков.
+ * Всего создается не больше ADAPTIVE_MAX_INTERVALS интервалов: когда предел исчерпан
+ * (например, функция возвращает NaN), интервалы принимаются без деления, а в результате
+ * converged = false; набор разделенных интервалов тогда зависит от порядка обработки.
+ */
+AdaptiveResult integrate_adaptive(double a, double b, double tolerance, Integrand f = func) {
+    if (a == b) return AdaptiveResult();
+
+    const int threads = omp_get_max_threads();
+    std::vector<std::unique_ptr<IntervalDeque>> deques;
+    for (int i = 0; i < threads; ++i) {
+        deques.emplace_back(new IntervalDeque());
+    }
+    std::vector<std::vector<Piece>> accepted(threads);
+    std::atomic<long long> pending{ 1 };
+    std::atomic<long long> created{ 1 };
+    deques[0]->push({ a, b, 0 });
+
+    const double length = fabs(b - a);
+    long long quadratures = 0;
+    long long steals = 0;
+    int unconverged = 0;
+
+#pragma omp parallel num_threads(threads) reduction(+:quadratures, steals) reduction(|:unconverged)
+    {
+        const int id = omp_get_thread_num();
+        const int team = omp_get_num_threads();
+        IntervalDeque& own = *deques[id];
+        std::vector<Piece>& pieces = accepted[id];
+
+        while (true) {
+            Interval interval;
+            bool found = own.pop(interval);
+            for (int k = 1; !found && k < team; ++k) {
+                found = deques[(id + k) % team]->steal(interval);
+                if (found) steals++;
+            }
+            if (!found) {
+                if (pending.load() == 0) break;
+                std::this_thread::yield();
+                continue;
+            }
+
+            double error = 0.0;
+            double value = kronrod15(f, interval.a, interval.b, error);
+            quadratures++;
+            // Для NaN сравнение ложно, и интервал делится, пока не исчерпаны пределы
+            bool accurate = error <= tolerance * fabs(interval.b - interval.a) / length;
+            bool can_split = !accurate && interval.depth < ADAPTIVE_MAX_DEPTH
+                && created.fetch_add(2) + 2 <= ADAPTIVE_MAX_INTERVALS;
+            if (!can_split) {
+                if (!accurate) unconverged = 1;
+                pieces.push_back({ interval.a, value, error });
+                pending.fetch_sub(1);
+            }
+            else {
+                // Две половины вместо одного интервала; счетчик увеличивается до того, как их можно украсть
+                double middle = 0.5 * (interval.a + interval.b);
+                pending.fetch_add(1);
+                own.push({ interval.a, middle, interval.depth + 1 });
+                own.push({ middle, interval.b, interval.depth + 1 });
+            }
+        }
+    }
+
+    std::vector<Piece> pieces;
+    for (const std::vector<Piece>& local : accepted) {
+        pieces.insert(pieces.end(), local.begin(), local.end());
+    }
+    std::sort(pieces.begin(), pieces.end(), [](const Piece& x, const Piece& y) { return x.a < y.a; });
+
+    AdaptiveResult result;
+    for (const Piece& piece : pieces) {
+        result.value += piece.value;
+        result.error += piece.error;
+    }
+    result.evaluations = quadratures * 15;
+    result.intervals = pieces.size();
+    result.steals = steals;
+    result.converged = unconverged == 0;
+    return result;
+}
+
+// Сравнение адаптивного интегрирования с параллельным методом прямоугольников на n точках
+void compare_adaptive(const char* name, Integrand f, double exact, double a, double b, int n, double tolerance) {
+    auto start_fixed = std::chrono::high_resolution_clock::now();
+    double fixed = integrate_parallel(a, b, n, f);
+    std::chrono::duration<double> elapsed_fixed = std::chrono::high_resolution_clock::now() - start_fixed;
+
+    auto start_adaptive = std::chrono::high_resolution_clock::now();
+    AdaptiveResult adaptive = integrate_adaptive(a, b, tolerance, f);
+    std::chrono::duration<double> elapsed_adaptive = std::chrono::high_resolution_clock::now() - start_adaptive;
+
+    std::cout << "\n" << name << ", точное значение " << std::setprecision(15) << exact << std::endl;
+    std::cout << std::setprecision(6);
+    std::cout << "Прямоугольники, n = " << n << ": погрешность " << fabs(fixed - exact)
+        << ", вычислений функции " << n << ", время " << elapsed_fixed.count() << " с" << std::endl;
+    std::cout << "G7-K15, допуск " << tolerance << ": погрешность " << fabs(adaptive.value - exact)
+        << " (оценка " << adaptive.error << "), вычислений функции " << adaptive.evaluations
+        << ", интервалов " << adaptive.intervals << ", краж " << adaptive.steals
+        << ", время " << elapsed_adaptive.count() << " с"
+        << (adaptive.converged ? "" : " (допуск не достигнут: исчерпан предел деления)") << std::endl;
+    std::cout << "Вычислений меньше в " << static_cast<double>(n) / adaptive.evaluations << " раз, быстрее в "
+        << elapsed_fixed.count() / elapsed_adaptive.count() << " раз" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
     SetConsoleOutputCP(CP_UTF8);
     setlocale(LC_ALL, "Russian");
     // Пределы интегрирования
@@ -60,6 +300,10 @@ int main() {
     // Количество интервалов (должно быть достаточно большим для точности)
     int n = 10000000;
 
+    // Lab7 <допуск>: допустимая погрешность адаптивного интегрирования
+    double tolerance = argc > 1 ? atof(argv[1]) : ADAPTIVE_TOLERANCE;
+    if (!(tolerance > 0)) tolerance = ADAPTIVE_TOLERANCE;
+
     // Аналитическое решение для сравнения
     double analytical = analytical_solution(a, b);
 
@@ -87,5 +331,10 @@ int main() {
     std::cout << "Время параллельного вычисления:      " << elapsed_par.count() << " с" << std::endl;
     std::cout << "Ускорение:            " << elapsed_seq.count() / elapsed_par.count() << std::endl;
 
+    // Адаптивное интегрирование гладкой функции и функции с пиком (потоков omp_get_max_threads())
+    std::cout << "\nАдаптивное интегрирование G7-K15 (потоков " << omp_get_max_threads() << "):" << std::endl;
+    compare_adaptive("e^(-x^2)", func, analytical, a, b, n, tolerance);
+    compare_adaptive("1 / ((x - 0.3)^2 + 1e-6)", spike, spike_solution(a, b), a, b, n, tolerance);
+
     return 0;
 }
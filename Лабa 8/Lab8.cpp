@@ -1,14 +1,18 @@
 #include <iostream>
 #include <vector>
-#include <random>
 #include <chrono>
 #include <omp.h>
 #include <stdexcept>
 #include <cmath>
+#include <string>
+#include <algorithm>
 #include <windows.h>
 #include <locale>
+#include "../common/matrix.h"
+#include "../common/counter_rng.h"
+#include "../common/numa.h"
 
-using matrix = std::vector<std::vector<double>>;
+using matrix = Matrix<double>;
 
 // Генерация случайной матрицы размером r x c
 matrix generate(int r, int c) {
@@ -16,15 +20,14 @@ matrix generate(int r, int c) {
         throw std::invalid_argument("Размеры матрицы должны быть положительными");
     }
 
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<> dis(0.0, 10.0);
-
-    matrix result(r, std::vector<double>(c));
+    // Строки заполняются параллельно, элемент (i, j) - число с номером i * c + j.
+    // Матрица не обнуляется главным потоком: строку первым касается тот поток,
+    // который потом умножает ее в multiply_parallel (то же разбиение schedule(static))
+    const CounterRng rng(random_seed());
+    matrix result(r, c, MatrixNoInit());
+#pragma omp parallel for schedule(static)
     for (int i = 0; i < r; ++i) {
-        for (int j = 0; j < c; ++j) {
-            result[i][j] = dis(gen);
-        }
+        rng.fill_real(result[i], c, 0.0, 10.0, static_cast<uint64_t>(i) * c);
     }
     return result;
 }
@@ -34,13 +37,7 @@ void check_dimensions(const matrix& a, const std::vector<double>& b) {
     if (a.empty() || b.empty()) {
         throw std::invalid_argument("Матрица или вектор пусты");
     }
-    size_t cols = a[0].size();
-    for (const auto& row : a) {
-        if (row.size() != cols) {
-            throw std::invalid_argument("Матрица должна быть прямоугольной");
-        }
-    }
-    if (cols != b.size()) {
+    if (a.cols() != b.size()) {
         throw std::invalid_argument("Число столбцов матрицы должно совпадать с размером вектора");
     }
 }
@@ -49,8 +46,8 @@ void check_dimensions(const matrix& a, const std::vector<double>& b) {
 std::vector<double> multiply(const matrix& a, const std::vector<double>& b) {
     check_dimensions(a, b);
 
-    size_t rows = a.size();
-    size_t cols = a[0].size();
+    size_t rows = a.rows();
+    size_t cols = a.cols();
     std::vector<double> result(rows, 0.0);
 
     for (size_t i = 0; i < rows; ++i) {
@@ -66,11 +63,11 @@ std::vector<double> multiply(const matrix& a, const std::vector<double>& b) {
 std::vector<double> multiply_parallel(const matrix& a, const std::vector<double>& b) {
     check_dimensions(a, b);
 
-    size_t rows = a.size();
-    size_t cols = a[0].size();
+    size_t rows = a.rows();
+    size_t cols = a.cols();
     std::vector<double> result(rows, 0.0);
 
-#pragma omp parallel for
+#pragma omp parallel for schedule(static)
     for (int i = 0; i < static_cast<int>(rows); ++i) {
         double sum = 0.0;
         for (size_t j = 0; j < cols; ++j) {
@@ -107,7 +104,7 @@ void compare(const matrix& a, const std::vector<double>& b) {
         }
 
         // Вывод результатов
-        std::cout << "Размер матрицы: " << a.size() << "x" << a[0].size() << "\n";
+        std::cout << "Размер матрицы: " << a.rows() << "x" << a.cols() << "\n";
         std::cout << "Размер вектора: " << b.size() << "\n";
         std::cout << "Время последовательного выполнения: " << seq_time.count() << " секунд\n";
         std::cout << "Время параллельного выполнения: " << par_time.count() << " секунд\n";
@@ -119,10 +116,51 @@ void compare(const matrix& a, const std::vector<double>& b) {
     }
 }
 
-int main() {
+// Скорость чтения матрицы потоками каждого узла NUMA при параллельном умножении
+void benchmark_numa(const matrix& a, const std::vector<double>& b) {
+    check_dimensions(a, b);
+    const size_t cols = a.cols();
+    std::vector<double> result(a.rows(), 0.0);
+
+    // Участки потоков совпадают с разбиением schedule(static) в generate и multiply_parallel
+    std::vector<NodeBandwidth> report = measure_node_bandwidth(a.data(), a.rows(), a.ld() * sizeof(double), 3,
+        [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                double sum = 0.0;
+                for (size_t j = 0; j < cols; ++j) {
+                    sum += a[i][j] * b[j];
+                }
+                result[i] = sum;
+            }
+        });
+
+    double total_bytes = 0.0;
+    double total_time = 0.0;
+    std::cout << "\nПропускная способность по узлам NUMA:\n";
+    for (const NodeBandwidth& node : report) {
+        total_bytes += node.bytes;
+        total_time = std::max(total_time, node.seconds);
+        std::cout << "Узел " << node.node << ": потоков " << node.threads << ", "
+            << node.bytes / node.seconds / 1e9 << " ГБ/с, ";
+        if (node.checked_pages > 0) {
+            std::cout << "локальных страниц " << 100.0 * node.local_pages / node.checked_pages << "%\n";
+        }
+        else {
+            std::cout << "размещение страниц неизвестно\n";
+        }
+    }
+    std::cout << "Всего: " << total_bytes / total_time / 1e9 << " ГБ/с\n";
+}
+
+int main(int argc, char* argv[]) {
     SetConsoleOutputCP(CP_UTF8);
     setlocale(LC_ALL, "Russian");
 
+    // Lab8 --pin: потоки OpenMP закрепляются за процессорами до размещения матрицы
+    if (argc > 1 && std::string(argv[1]) == "--pin") {
+        std::cout << "Потоков закреплено за процессорами: " << pin_threads() << std::endl;
+    }
+
     try {
         const int size = 10000; // Размер матрицы и вектора
 
@@ -133,6 +171,7 @@ int main() {
 
         // Сравнение производительности
         compare(mat, vec);
+        benchmark_numa(mat, vec);
 
     }
     catch (const std::exception& e) {
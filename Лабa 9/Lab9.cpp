@@ -1,11 +1,11 @@
 ﻿#include <iostream>
 #include <vector>
-#include <random>
 #include <chrono>
 #include <thread>
 #include <omp.h>
 #include <windows.h>
 #include <locale>
+#include "../common/counter_rng.h"
 
 /*
  * Класс для реализации игры "Жизнь" Конвея
@@ -22,15 +22,16 @@ public:
 
     // Инициализация поля случайным образом
     // alive_prob - вероятность появления живой клетки (0.0-1.0)
-    void random_init(double alive_prob = 0.3) {
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::bernoulli_distribution dist(alive_prob);
+    // Клетка (x, y) берет число с номером y * width + x, поэтому поле не зависит от числа потоков
+    void random_init(double alive_prob = 0.3, uint64_t seed = random_seed()) {
+        const CounterRng rng(seed);
 
-#pragma omp parallel for num_threads(num_threads) collapse(2)
+        // Строка std::vector<bool> хранит клетки битами одного слова,
+        // поэтому каждую строку заполняет один поток
+#pragma omp parallel for num_threads(num_threads)
         for (int y = 0; y < height; ++y) {
             for (int x = 0; x < width; ++x) {
-                current_grid[y][x] = dist(gen);
+                current_grid[y][x] = rng.uniform(static_cast<uint64_t>(y) * width + x) < alive_prob;
             }
         }
         generation = 0;
@@ -59,7 +60,7 @@ public:
 
     // Очистка поля (все клетки становятся мертвыми)
     void clear() {
-#pragma omp parallel for num_threads(num_threads) collapse(2)
+#pragma omp parallel for num_threads(num_threads)
         for (int y = 0; y < height; ++y) {
             for (int x = 0; x < width; ++x) {
                 current_grid[y][x] = false;
@@ -70,7 +71,7 @@ public:
 
     // Выполнение одного шага эволюции (переход к следующему поколению)
     void step() {
-#pragma omp parallel for num_threads(num_threads) collapse(2)
+#pragma omp parallel for num_threads(num_threads)
         for (int y = 0; y < height; ++y) {
             for (int x = 0; x < width; ++x) {
                 int neighbors = count_neighbors(x, y);
@@ -193,4 +194,4 @@ int main() {
 
     std::cout << "\nСимуляция завершена после " << max_generations << " поколений." << std::endl;
     return 0;
-}
\ No newline at end of file
+}
\ No newline at end of file
@@ -4,11 +4,16 @@
 #include <time.h>
 #include <locale.h>
 #include <limits.h> // Для LLONG_MAX
+#include "../common/packed_array.h"
+
+// Объявленный диапазон значений массива: по нему выбирается ширина упакованного хранения
+#define VALUE_MIN 0
+#define VALUE_MAX 99
 
 // Функция для генерации случайного массива
 void generate_random_array(int* array, int size) {
     for (int i = 0; i < size; i++) {
-        array[i] = rand() % 100;
+        array[i] = VALUE_MIN + rand() % (VALUE_MAX - VALUE_MIN + 1);
     }
 }
 
@@ -45,6 +50,15 @@ int main(int argc, char** argv) {
     int remainder = array_size % size;
     int local_size = base_size + (rank < remainder ? 1 : 0);
 
+    // Размеры и смещения частей процессов (при остатке части различаются на 1)
+    int* counts = (int*)malloc(size * sizeof(int));
+    int* displs = (int*)malloc(size * sizeof(int));
+    for (int i = 0, offset = 0; i < size; i++) {
+        counts[i] = base_size + (i < remainder ? 1 : 0);
+        displs[i] = offset;
+        offset += counts[i];
+    }
+
     if (rank == 0) {
         global_array = (int*)malloc(array_size * sizeof(int));
         if (!global_array) {
@@ -69,7 +83,7 @@ int main(int argc, char** argv) {
         MPI_Abort(MPI_COMM_WORLD, 1);
     }
 
-    MPI_Scatter(global_array, local_size, MPI_INT,
+    MPI_Scatterv(global_array, counts, displs, MPI_INT,
         local_array, local_size, MPI_INT,
         0, MPI_COMM_WORLD);
 
@@ -91,13 +105,61 @@ int main(int argc, char** argv) {
     par_time = end_time - start_time;
 
     if (rank == 0) {
-        printf("Параллельное вычисление: сумма = %lld (время: %.6f сек)\n",
-            global_sum, par_time);
+        printf("Параллельное вычисление: сумма = %lld (время: %.6f сек, %.2f ГБ/с)\n",
+            global_sum, par_time, array_size * sizeof(int) / 1e9 / par_time);
         printf("Ускорение: %.2f раз\n", seq_time / par_time);
+    }
+
+    // Упакованное хранение: значения 0..99 занимают 1 байт вместо 4
+    int width = packed_width(VALUE_MIN, VALUE_MAX);
+    unsigned char* global_packed = NULL;
+    unsigned char* local_packed = (unsigned char*)malloc((size_t)local_size * width);
+    if (!local_packed) {
+        fprintf(stderr, "Ошибка выделения памяти в процессе %d\n", rank);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    if (rank == 0) {
+        global_packed = (unsigned char*)malloc((size_t)array_size * width);
+        if (!global_packed) {
+            fprintf(stderr, "Ошибка выделения памяти для global_packed\n");
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        pack_values(global_array, array_size, VALUE_MIN, width, global_packed);
+    }
+
+    for (int i = 0; i < size; i++) {
+        counts[i] *= width;
+        displs[i] *= width;
+    }
+    MPI_Scatterv(global_packed, counts, displs, MPI_BYTE,
+        local_packed, local_size * width, MPI_BYTE,
+        0, MPI_COMM_WORLD);
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    start_time = MPI_Wtime();
+
+    // Байты суммируются в 64-битных полосах (psadbw), переполнение невозможно
+    long long local_packed_sum = (long long)packed_sum(local_packed, local_size, width) + (long long)VALUE_MIN * local_size;
+    long long global_packed_sum = 0;
+    MPI_Reduce(&local_packed_sum, &global_packed_sum, 1, MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+
+    end_time = MPI_Wtime();
+    double packed_time = end_time - start_time;
+
+    if (rank == 0) {
+        printf("Упакованное хранение (%d байт на элемент): сумма = %lld (время: %.6f сек, %.2f ГБ/с)\n",
+            width, global_packed_sum, packed_time, (double)array_size * width / 1e9 / packed_time);
+        printf("Суммы int32 и упакованного массива %s\n", global_packed_sum == global_sum ? "совпадают" : "НЕ совпадают");
+        printf("Память: int32 %.1f МБ, упакованный массив %.1f МБ\n",
+            array_size * sizeof(int) / (1024.0 * 1024.0), (double)array_size * width / (1024.0 * 1024.0));
         free(global_array);
+        free(global_packed);
     }
 
     free(local_array);
+    free(local_packed);
+    free(counts);
+    free(displs);
     MPI_Finalize();
     return 0;
-}
\ No newline at end of file
+}
\ No newline at end of file
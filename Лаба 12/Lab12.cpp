@@ -4,25 +4,34 @@
 #include <mpi.h>
 #include <windows.h>
 #include <locale>
+#include <stdint.h>
+#include <string.h>
+#include "../common/typed_gemm.h"
+#include "../common/counter_rng.h"
 
 // Константы программы
 #define MATRIX_SIZE 500          // Размер квадратных матриц (N x N)
 #define MIN_RAND_VALUE 1         // Минимальное значение элементов матрицы
 #define MAX_RAND_VALUE 10        // Максимальное значение элементов матрицы
 
+// Элементы 1..10 помещаются в int8, сумма N произведений - в int32:
+// матрицы A и B передаются и читаются по байту на элемент вместо четырех
+typedef int8_t element_t;        // Тип элементов A и B
+typedef int32_t accum_t;         // Тип элементов C (накопление)
+#define MPI_ELEMENT_T MPI_INT8_T
+#define MPI_ACCUM_T MPI_INT32_T
+
 /**
  * Заполняет матрицу случайными числами в заданном диапазоне
  * @param matrix Указатель на матрицу
  * @param rows Количество строк
  * @param cols Количество столбцов
+ * @param seed Начальное значение генератора: элемент i - число с номером i этого потока,
+ *             матрица заполняется параллельно и не зависит от числа потоков
  */
-void fill_matrix(int* matrix, int rows, int cols) {
-    for (int i = 0; i < rows; i++) {
-        for (int j = 0; j < cols; j++) {
-            // Генерация случайного числа в диапазоне [MIN_RAND_VALUE, MAX_RAND_VALUE]
-            matrix[i * cols + j] = MIN_RAND_VALUE + rand() % (MAX_RAND_VALUE - MIN_RAND_VALUE + 1);
-        }
-    }
+void fill_matrix(element_t* matrix, int rows, int cols, uint64_t seed) {
+    // Генерация случайных чисел в диапазоне [MIN_RAND_VALUE, MAX_RAND_VALUE]
+    parallel_fill_int(matrix, (size_t)rows * cols, MIN_RAND_VALUE, MAX_RAND_VALUE, seed);
 }
 
 /**
@@ -32,15 +41,68 @@ void fill_matrix(int* matrix, int rows, int cols) {
  * @param cols Количество столбцов в матрице
  * @param slice_size Размер среза (например, 5 для вывода 5x5 элементов)
  */
-void print_matrix_slice(int* matrix, int rows, int cols, int slice_size) {
+void print_matrix_slice(accum_t* matrix, int rows, int cols, int slice_size) {
     for (int i = 0; i < slice_size && i < rows; i++) {
         for (int j = 0; j < slice_size && j < cols; j++) {
-            printf("%d ", matrix[i * cols + j]);
+            printf("%d ", (int)matrix[i * cols + j]);
         }
         printf("\n");
     }
 }
 
+/**
+ * Умножение полных матриц в одном процессе с элементами типа T и накоплением в Acc
+ * @return Время умножения (сек), результат записывается в C
+ */
+template <typename T, typename Acc>
+double multiply_typed(const element_t* A, const element_t* B, Acc* C) {
+    const int n = MATRIX_SIZE;
+    T* A_typed = (T*)malloc(n * n * sizeof(T));
+    T* B_typed = (T*)malloc(n * n * sizeof(T));
+    for (int i = 0; i < n * n; i++) {
+        A_typed[i] = (T)A[i];
+        B_typed[i] = (T)B[i];
+    }
+    memset(C, 0, n * n * sizeof(Acc));
+
+    double start = MPI_Wtime();
+    gemm_typed<T, Acc>(n, n, n, A_typed, n, B_typed, n, C, n);
+    double time = MPI_Wtime() - start;
+
+    free(A_typed);
+    free(B_typed);
+    return time;
+}
+
+/**
+ * Сравнение скорости и точности умножения для int32, int16 и int8 элементов
+ * (накопление в int32). Эталон - результат MPI-умножения C.
+ * @param A, B Исходные матрицы
+ * @param C Результат параллельного умножения
+ */
+void benchmark_types(const element_t* A, const element_t* B, const accum_t* C) {
+    const int n = MATRIX_SIZE;
+    const double ops = 2.0 * n * n * n;
+    accum_t* result = (accum_t*)malloc(n * n * sizeof(accum_t));
+
+    printf("\nСравнение типов элементов (один процесс):\n");
+    const char* names[3] = { "int32", "int16", "int8" };
+    for (int t = 0; t < 3; t++) {
+        double time = 0;
+        if (t == 0) time = multiply_typed<int32_t, int32_t>(A, B, result);
+        if (t == 1) time = multiply_typed<int16_t, int32_t>(A, B, result);
+        if (t == 2) time = multiply_typed<int8_t, int32_t>(A, B, result);
+
+        long long max_error = 0;
+        for (int i = 0; i < n * n; i++) {
+            long long error = llabs((long long)result[i] - C[i]);
+            if (error > max_error) max_error = error;
+        }
+        printf("%s: %.4f сек, %.2f GOPS, макс. отклонение %lld\n", names[t], time, ops / time / 1e9, max_error);
+    }
+    free(result);
+}
+
 int main(int argc, char* argv[]) {
     SetConsoleOutputCP(CP_UTF8);
     setlocale(LC_ALL, "Russian");
@@ -66,27 +128,28 @@ int main(int argc, char* argv[]) {
     int rows_per_process = MATRIX_SIZE / size;
 
     // Объявление указателей на матрицы
-    int* A = NULL;    // Исходная матрица A (только в процессе 0)
-    int* B = NULL;    // Исходная матрица B (только в процессе 0)
-    int* C = NULL;    // Результирующая матрица C (только в процессе 0)
+    element_t* A = NULL;    // Исходная матрица A (только в процессе 0)
+    accum_t* C = NULL;      // Результирующая матрица C (только в процессе 0)
+
+    // Матрица B нужна целиком во всех процессах (принимает MPI_Bcast)
+    element_t* B = (element_t*)malloc(MATRIX_SIZE * MATRIX_SIZE * sizeof(element_t));
 
     // Выделяем память для локальных частей матриц в каждом процессе
-    int* local_A = (int*)malloc(rows_per_process * MATRIX_SIZE * sizeof(int)); // Локальная часть матрицы A
-    int* local_C = (int*)malloc(rows_per_process * MATRIX_SIZE * sizeof(int)); // Локальная часть матрицы C
+    element_t* local_A = (element_t*)malloc(rows_per_process * MATRIX_SIZE * sizeof(element_t)); // Локальная часть матрицы A
+    accum_t* local_C = (accum_t*)malloc(rows_per_process * MATRIX_SIZE * sizeof(accum_t));       // Локальная часть матрицы C
 
     // Процесс с рангом 0 инициализирует исходные матрицы A и B
     if (rank == 0) {
         // Выделяем память для полных матриц
-        A = (int*)malloc(MATRIX_SIZE * MATRIX_SIZE * sizeof(int));
-        B = (int*)malloc(MATRIX_SIZE * MATRIX_SIZE * sizeof(int));
-        C = (int*)malloc(MATRIX_SIZE * MATRIX_SIZE * sizeof(int));
+        A = (element_t*)malloc(MATRIX_SIZE * MATRIX_SIZE * sizeof(element_t));
+        C = (accum_t*)malloc(MATRIX_SIZE * MATRIX_SIZE * sizeof(accum_t));
 
-        // Инициализация генератора случайных чисел
-        srand(time(NULL));
+        // Начальное значение генератора; у A и B разные ключи, поэтому потоки чисел независимы
+        uint64_t seed = (uint64_t)time(NULL);
 
         // Заполнение матриц случайными значениями
-        fill_matrix(A, MATRIX_SIZE, MATRIX_SIZE);
-        fill_matrix(B, MATRIX_SIZE, MATRIX_SIZE);
+        fill_matrix(A, MATRIX_SIZE, MATRIX_SIZE, seed);
+        fill_matrix(B, MATRIX_SIZE, MATRIX_SIZE, seed + 1);
 
         // Засекаем время начала вычислений
         start_time = MPI_Wtime();
@@ -98,10 +161,10 @@ int main(int argc, char* argv[]) {
     // MPI_Scatter разделяет массив на равные части и рассылает их всем процессам
     MPI_Scatter(A,                       // Исходный буфер (только в корневом процессе)
         rows_per_process * MATRIX_SIZE, // Количество элементов для каждого процесса
-        MPI_INT,                 // Тип данных
+        MPI_ELEMENT_T,           // Тип данных
         local_A,                 // Приемный буфер в каждом процессе
         rows_per_process * MATRIX_SIZE, // Количество получаемых элементов
-        MPI_INT,                 // Тип данных
+        MPI_ELEMENT_T,           // Тип данных
         0,                       // Ранг корневого процесса
         MPI_COMM_WORLD);         // Коммуникатор
 
@@ -109,31 +172,25 @@ int main(int argc, char* argv[]) {
     // MPI_Bcast рассылает данные из корневого процесса всем процессам
     MPI_Bcast(B,                        // Буфер с данными
         MATRIX_SIZE * MATRIX_SIZE, // Количество элементов
-        MPI_INT,                  // Тип данных
+        MPI_ELEMENT_T,            // Тип данных
         0,                        // Ранг корневого процесса
         MPI_COMM_WORLD);          // Коммуникатор
 
     // Параллельное умножение матриц:
     // Каждый процесс умножает свою часть матрицы A на матрицу B
-    for (int i = 0; i < rows_per_process; i++) {
-        for (int j = 0; j < MATRIX_SIZE; j++) {
-            local_C[i * MATRIX_SIZE + j] = 0; // Инициализация элемента результата
-
-            // Вычисление скалярного произведения строки и столбца
-            for (int k = 0; k < MATRIX_SIZE; k++) {
-                local_C[i * MATRIX_SIZE + j] += local_A[i * MATRIX_SIZE + k] * B[k * MATRIX_SIZE + j];
-            }
-        }
-    }
+    // (int8 -> int32, векторное ядро AVX2 при наличии)
+    memset(local_C, 0, rows_per_process * MATRIX_SIZE * sizeof(accum_t));
+    gemm_typed<element_t, accum_t>(rows_per_process, MATRIX_SIZE, MATRIX_SIZE,
+        local_A, MATRIX_SIZE, B, MATRIX_SIZE, local_C, MATRIX_SIZE);
 
     // Сбор результатов в процессе 0:
     // MPI_Gather собирает части матрицы C со всех процессов в один массив
     MPI_Gather(local_C,                 // Отправляемые данные (локальная часть C)
         rows_per_process * MATRIX_SIZE, // Количество элементов
-        MPI_INT,                 // Тип данных
+        MPI_ACCUM_T,             // Тип данных
         C,                       // Приемный буфер (только в корневом процессе)
         rows_per_process * MATRIX_SIZE, // Количество элементов от каждого процесса
-        MPI_INT,                 // Тип данных
+        MPI_ACCUM_T,             // Тип данных
         0,                       // Ранг корневого процесса
         MPI_COMM_WORLD);         // Коммуникатор
 
@@ -155,17 +212,20 @@ int main(int argc, char* argv[]) {
         printf("Количество процессов: %d\n", size);
         printf("Время выполнения: %.3f сек\n", end_time - start_time);
 
+        // 3. Сравнение типов элементов на полных матрицах в процессе 0
+        benchmark_types(A, B, C);
+
         // Освобождаем память, выделенную в процессе 0
         free(A);
-        free(B);
         free(C);
     }
 
     // Освобождаем память, выделенную в каждом процессе
+    free(B);
     free(local_A);
     free(local_C);
 
     // Завершение работы с MPI
     MPI_Finalize();
     return 0;
-}
\ No newline at end of file
+}
\ No newline at end of file